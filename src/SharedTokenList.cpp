@@ -0,0 +1,92 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "SharedTokenList.h"
+
+SharedTokenList::SharedTokenList() {
+  data = new Data();
+  data->references = 1;
+}
+
+SharedTokenList::SharedTokenList(const TokenList &tokens) {
+  data = new Data();
+  data->tokens = tokens;
+  data->references = 1;
+}
+
+SharedTokenList::SharedTokenList(const SharedTokenList &s) {
+  data = s.data;
+  data->references++;
+}
+
+SharedTokenList::~SharedTokenList() {
+  release();
+}
+
+void SharedTokenList::release() {
+  if (--data->references == 0)
+    delete data;
+}
+
+SharedTokenList& SharedTokenList::operator=(const SharedTokenList &s) {
+  s.data->references++;
+  release();
+  data = s.data;
+  return *this;
+}
+
+const TokenList& SharedTokenList::operator*() const {
+  return data->tokens;
+}
+
+const TokenList* SharedTokenList::operator->() const {
+  return &data->tokens;
+}
+
+TokenList& SharedTokenList::modify() {
+  Data* copy;
+  
+  if (isShared()) {
+    copy = new Data();
+    copy->tokens = data->tokens;
+    copy->references = 1;
+    release();
+    data = copy;
+  }
+  return data->tokens;
+}
+
+void SharedTokenList::swap(TokenList &tokens) {
+  Data* copy;
+
+  if (isShared()) {
+    copy = new Data();
+    copy->references = 1;
+    release();
+    data = copy;
+  }
+  data->tokens.swap(tokens);
+  tokens.clear();
+}
+
+bool SharedTokenList::isShared() const {
+  return data->references > 1;
+}
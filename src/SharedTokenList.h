@@ -0,0 +1,72 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __SharedTokenList_h__
+#define __SharedTokenList_h__
+
+#include "TokenList.h"
+
+/**
+ * Reference counted, copy-on-write token list. Copying a
+ * SharedTokenList only increases the reference count, so variable
+ * values and mixin arguments can be passed through several scopes
+ * without copying the tokens.
+ *
+ * The tokens can only be changed through modify(), which makes a
+ * private copy first if the list is shared.
+ */
+class SharedTokenList {
+private:
+  struct Data {
+    TokenList tokens;
+    unsigned int references;
+  };
+  Data* data;
+
+  void release();
+  
+public:
+  SharedTokenList();
+  SharedTokenList(const TokenList &tokens);
+  SharedTokenList(const SharedTokenList &s);
+  ~SharedTokenList();
+
+  SharedTokenList& operator=(const SharedTokenList &s);
+
+  const TokenList& operator*() const;
+  const TokenList* operator->() const;
+
+  /**
+   * Returns a token list that can be modified without affecting the
+   * other references.
+   */
+  TokenList& modify();
+
+  /**
+   * Replace the tokens with the contents of the given list. The list
+   * is left empty.
+   */
+  void swap(TokenList &tokens);
+
+  bool isShared() const;
+};
+
+#endif
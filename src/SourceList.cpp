@@ -0,0 +1,86 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "SourceList.h"
+
+SourceList::SourceList() {
+  keepContents = false;
+}
+
+SourceList::~SourceList() {
+}
+
+void SourceList::setKeepContents(bool keep) {
+  keepContents = keep;
+}
+
+bool SourceList::isKeepingContents() const {
+  return keepContents;
+}
+
+size_t SourceList::addSource(const char* file) {
+  size_t index = files.size();
+
+  files.push_back(file);
+  indices.insert(std::pair<const char*, size_t>(file, index));
+  names.insert(std::pair<std::string, size_t>(file, index));
+  if (keepContents)
+    contents[file];
+  return index;
+}
+
+bool SourceList::contains(const std::string &file) const {
+  return names.find(file) != names.end();
+}
+
+size_t SourceList::indexOf(const char* file) const {
+  std::unordered_map<const char*, size_t>::const_iterator i =
+    indices.find(file);
+
+  return (i == indices.end()) ? NOT_FOUND : i->second;
+}
+
+std::string* SourceList::getContent(const char* file) {
+  std::unordered_map<const char*, std::string>::iterator i =
+    contents.find(file);
+
+  return (i == contents.end()) ? NULL : &i->second;
+}
+
+SourceList::const_iterator SourceList::begin() const {
+  return files.begin();
+}
+
+SourceList::const_iterator SourceList::end() const {
+  return files.end();
+}
+
+size_t SourceList::size() const {
+  return files.size();
+}
+
+bool SourceList::empty() const {
+  return files.empty();
+}
+
+const char* SourceList::front() const {
+  return files.front();
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __SourceList_h__
+#define __SourceList_h__
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+/**
+ * The list of source files of a stylesheet, in the order they were
+ * imported. Sources are indexed by name and by pointer, so checking
+ * for an import and looking up the index of a token's source does not
+ * walk the list.
+ */
+class SourceList {
+private:
+  std::list<const char*> files;
+  std::unordered_map<const char*, size_t> indices;
+  std::unordered_map<std::string, size_t> names;
+  std::unordered_map<const char*, std::string> contents;
+  bool keepContents;
+  
+public:
+  typedef std::list<const char*>::const_iterator const_iterator;
+
+  /**
+   * Returned by indexOf() for a source that is not in the list.
+   */
+  static const size_t NOT_FOUND = (size_t)-1;
+  
+  SourceList();
+  virtual ~SourceList();
+
+  /**
+   * Keep the text of the sources that are added after this call, so
+   * it can be included in the source map.
+   */
+  void setKeepContents(bool keep);
+  bool isKeepingContents() const;
+
+  /**
+   * Add a source file and return its index. The pointer is stored,
+   * not copied.
+   */
+  size_t addSource(const char* file);
+
+  /**
+   * Returns true if a source with the given filename has been added.
+   */
+  bool contains(const std::string &file) const;
+
+  /**
+   * Returns the index of the source file, or NOT_FOUND if the pointer
+   * was not added to the list.
+   */
+  size_t indexOf(const char* file) const;
+
+  /**
+   * Returns the buffer that holds the text of the source file, or NULL
+   * if contents are not kept. The tokenizer fills the buffer as it
+   * reads the file.
+   */
+  std::string* getContent(const char* file);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  size_t size() const;
+  bool empty() const;
+  /**
+   * The first source, which is the main stylesheet.
+   */
+  const char* front() const;
+};
+
+#endif
@@ -29,20 +29,20 @@ const Token Token::BUILTIN_PAREN_OPEN("(", Token::PAREN_OPEN, 0,0, BUILTIN_SOURC
 const Token Token::BUILTIN_PAREN_CLOSED(")", Token::PAREN_CLOSED, 0,0, BUILTIN_SOURCE);
 
 Token::Token ():
-  line(0), column(0), source(BUILTIN_SOURCE), type(OTHER) {
+  plain(false), line(0), column(0), source(BUILTIN_SOURCE), type(OTHER) {
 }
 
 Token::Token (unsigned int line,
               unsigned int column,
               const char* source):
-  line(line), column(column), source(source), type(OTHER) {
+  plain(false), line(line), column(column), source(source), type(OTHER) {
 }
 
 Token::Token (const std::string &s, Type t,
               unsigned int line,
               unsigned int column,
               const char* source):
-  line(line), column(column), source(source) {
+  plain(false), line(line), column(column), source(source) {
   type = t;
   append(s);
 }
@@ -54,6 +54,7 @@ void Token::setLocation(const Token &ref)  {
 }
 
 void Token::clear () {
+  plain = false;
   std::string::clear();
   type = OTHER;
 }
@@ -27,6 +27,7 @@
 class Token: public std::string {
 
 protected:
+  bool plain;
  
 public:
   unsigned int line, column;
@@ -65,6 +66,19 @@ public:
    */
   void clear ();
 
+  /**
+   * Mark the token as plain, meaning it contains no '@{variable}'
+   * that needs to be interpolated. The tokenizer marks the tokens it
+   * reads; the mark is removed when the token is changed with append(),
+   * assign() or clear().
+   */
+  inline void setPlain() {
+    plain = true;
+  }
+  inline bool isPlain() const {
+    return plain;
+  }
+
   /**
    * Returns true if the token string starts with a " or a '.
    */
@@ -88,11 +102,21 @@ public:
   std::string getUrlString() const;
   
   inline std::string& append(char c) {
+    plain = false;
     return std::string::append(1, c);
   }
   inline std::string& append(const std::string &c) {
+    plain = false;
     return std::string::append(c);
   }
+  inline std::string& assign(const std::string &str) {
+    plain = false;
+    return std::string::assign(str);
+  }
+  inline std::string& assign(const char* str, size_t n) {
+    plain = false;
+    return std::string::assign(str, n);
+  }
 
   inline bool operator == (const Token &t) const {
     return (type == t.type &&
@@ -119,7 +143,7 @@ public:
   }
 
   inline Token& operator= (const std::string& str) {
-    std::string::assign(str);
+    assign(str);
     return *this;
   }
 };
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "CompressedOutputSink.h"
+#include "IOException.h"
+
+#ifdef WITH_ZLIB
+
+GzipOutputSink::GzipOutputSink(OutputSink &out, int level): out(out) {
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+
+  // 15 + 16: the largest window, with a gzip header
+  if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 9,
+                   Z_DEFAULT_STRATEGY) != Z_OK)
+    throw new IOException("Error initializing zlib");
+  buffer = new unsigned char[BUFFER_SIZE];
+}
+
+GzipOutputSink::~GzipOutputSink() {
+  deflateEnd(&stream);
+  delete [] buffer;
+}
+
+void GzipOutputSink::compress(int flush) {
+  int ret;
+  
+  do {
+    stream.next_out = buffer;
+    stream.avail_out = BUFFER_SIZE;
+    
+    ret = ::deflate(&stream, flush);
+    if (ret == Z_STREAM_ERROR)
+      throw new IOException("Error compressing output");
+    
+    out.write((const char*)buffer, BUFFER_SIZE - stream.avail_out);
+  } while (stream.avail_out == 0);
+}
+
+void GzipOutputSink::write(const char* data, size_t length) {
+  stream.next_in = (Bytef*)data;
+  stream.avail_in = length;
+  compress(Z_NO_FLUSH);
+}
+
+void GzipOutputSink::close() {
+  stream.next_in = Z_NULL;
+  stream.avail_in = 0;
+  compress(Z_FINISH);
+  out.flush();
+}
+
+#endif
+
+#ifdef WITH_BROTLI
+
+BrotliOutputSink::BrotliOutputSink(OutputSink &out, int quality):
+  out(out) {
+  state = BrotliEncoderCreateInstance(NULL, NULL, NULL);
+  if (state == NULL)
+    throw new IOException("Error initializing brotli");
+
+  BrotliEncoderSetParameter(state, BROTLI_PARAM_QUALITY, quality);
+  BrotliEncoderSetParameter(state, BROTLI_PARAM_MODE, BROTLI_MODE_TEXT);
+  buffer = new unsigned char[BUFFER_SIZE];
+}
+
+BrotliOutputSink::~BrotliOutputSink() {
+  BrotliEncoderDestroyInstance(state);
+  delete [] buffer;
+}
+
+void BrotliOutputSink::compress(BrotliEncoderOperation op,
+                                const char* data, size_t length) {
+  const uint8_t* next_in = (const uint8_t*)data;
+  size_t available_out;
+  uint8_t* next_out;
+
+  do {
+    next_out = buffer;
+    available_out = BUFFER_SIZE;
+    
+    if (!BrotliEncoderCompressStream(state, op, &length, &next_in,
+                                     &available_out, &next_out, NULL))
+      throw new IOException("Error compressing output");
+
+    out.write((const char*)buffer, BUFFER_SIZE - available_out);
+  } while (length > 0 || BrotliEncoderHasMoreOutput(state) ||
+           (op == BROTLI_OPERATION_FINISH &&
+            !BrotliEncoderIsFinished(state)));
+}
+
+void BrotliOutputSink::write(const char* data, size_t length) {
+  compress(BROTLI_OPERATION_PROCESS, data, length);
+}
+
+void BrotliOutputSink::close() {
+  compress(BROTLI_OPERATION_FINISH, NULL, 0);
+  out.flush();
+}
+
+#endif
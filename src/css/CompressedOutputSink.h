@@ -0,0 +1,87 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __CompressedOutputSink_h__
+#define __CompressedOutputSink_h__
+
+#include "OutputSink.h"
+
+#include <config.h>
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef WITH_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#ifdef WITH_ZLIB
+/**
+ * Compresses the output in the gzip format and writes it to another
+ * sink. The stream is finished by close().
+ */
+class GzipOutputSink: public OutputSink {
+private:
+  static const size_t BUFFER_SIZE = 65536;
+  OutputSink &out;
+  z_stream stream;
+  unsigned char* buffer;
+
+  void compress(int flush);
+  
+public:
+  /**
+   * @param level the zlib compression level, 1-9.
+   */
+  GzipOutputSink(OutputSink &out, int level);
+  virtual ~GzipOutputSink();
+  virtual void write(const char* data, size_t length);
+  virtual void close();
+};
+#endif
+
+#ifdef WITH_BROTLI
+/**
+ * Compresses the output with brotli and writes it to another sink. The
+ * stream is finished by close().
+ */
+class BrotliOutputSink: public OutputSink {
+private:
+  static const size_t BUFFER_SIZE = 65536;
+  OutputSink &out;
+  BrotliEncoderState* state;
+  unsigned char* buffer;
+
+  void compress(BrotliEncoderOperation op, const char* data, size_t length);
+  
+public:
+  /**
+   * @param quality the brotli quality, 0-11.
+   */
+  BrotliOutputSink(OutputSink &out, int quality);
+  virtual ~BrotliOutputSink();
+  virtual void write(const char* data, size_t length);
+  virtual void close();
+};
+#endif
+
+#endif
@@ -108,6 +108,7 @@ MediaQuery* CssParser::parseMediaQuery(Stylesheet &stylesheet) {
   query = stylesheet.createMediaQuery();
 
   query->getSelector().push_back(tokenizer->getToken());
+  query->getSelector().push_back(Token::BUILTIN_SPACE);
 
   tokenizer->readNextToken();
   skipWhitespace();
@@ -30,7 +30,7 @@ void CssPrettyWriter::indent() {
 }
 
 void CssPrettyWriter::newline() {
-  out->write("\n", 1);
+  writeStr("\n", 1);
   column = 0;
   
   if (sourcemap != NULL)
@@ -94,7 +94,7 @@ void CssPrettyWriter::writeDeclaration(const Token &property,
   writeToken(property);
   writeStr(": ", 2);
 
-  writeValue(value);
+  writeDeclarationValue(property, value);
 }
 
 void CssPrettyWriter::writeDeclarationDeliminator() {
@@ -107,6 +107,12 @@ void CssPrettyWriter::writeComment(const Token &comment) {
   newline();
 }
 
+void CssPrettyWriter::writeInlineCss(const char* css, size_t len) {
+  CssWriter::writeInlineCss(css, len);
+  if (css[len - 1] != '\n')
+    newline();
+}
+
 void CssPrettyWriter::writeMediaQueryStart(const TokenList &selector) {
   indent();
   
@@ -45,6 +45,13 @@ public:
     CssWriter(out, sourcemap) {
     indent_size = 0;
   }
+  CssPrettyWriter(OutputSink &sink): CssWriter(sink) {
+    indent_size = 0;
+  };
+  CssPrettyWriter(OutputSink &sink, SourceMapWriter &sourcemap):
+    CssWriter(sink, sourcemap) {
+    indent_size = 0;
+  }
 
   virtual void writeAtRule(const Token &keyword, const TokenList &rule);
   virtual void writeRulesetStart(const TokenList &selector);
@@ -52,6 +59,7 @@ public:
   virtual void writeDeclaration(const Token &property, const TokenList &value);
   virtual void writeDeclarationDeliminator();
   virtual void writeComment(const Token &comment);
+  virtual void writeInlineCss(const char* css, size_t len);
   virtual void writeMediaQueryStart(const TokenList &selector);
   virtual void writeMediaQueryEnd();
 };
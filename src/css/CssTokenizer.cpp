@@ -28,7 +28,7 @@
 #endif
 
 CssTokenizer::CssTokenizer(istream &in, const char* source):
-  in(&in), line(0),  source(source) {
+  in(&in), capture(NULL), line(0),  source(source) {
   currentToken.source = source;
   readChar();
   column = 0;
@@ -41,6 +41,12 @@ const char* CssTokenizer::getSource() {
   return source;
 }
 
+void CssTokenizer::captureInput(std::string* buffer) {
+  capture = buffer;
+  if (capture != NULL && in != NULL)
+    capture->push_back(lastRead);
+}
+
 void CssTokenizer::readChar(){
   if (in == NULL) 
     return;
@@ -59,6 +65,8 @@ void CssTokenizer::readChar(){
     in = NULL;
   else if (in->fail() || in->bad())
     throw new IOException("Error reading input");
+  else if (capture != NULL)
+    capture->push_back(lastRead);
 
   if (lastReadEq('\n') && column > 0) // don't count newlines as chars
     column--;
@@ -215,6 +223,10 @@ Token::Type CssTokenizer::readNextToken(){
     }
     break;
   }
+
+  if (currentToken.find("@{") == string::npos)
+    currentToken.setPlain();
+  
 #ifdef WITH_LIBGLOG
   VLOG(4) << "Token: " << currentToken << "[" << currentToken.type
           << "]";
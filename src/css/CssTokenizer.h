@@ -116,9 +116,17 @@ public:
   Token::Type getTokenType();
 
   const char* getSource();
+
+  /**
+   * Append the characters read from the input to the buffer, starting
+   * with the one that has been read ahead. The buffer is not owned by
+   * the tokenizer. Passing NULL stops the capture.
+   */
+  void captureInput(std::string* buffer);
 		
 protected:
   istream* in;
+  std::string* capture;
 
   Token currentToken;
   char lastRead;
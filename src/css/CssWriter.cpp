@@ -22,28 +22,68 @@
 #include "CssWriter.h"
 
 CssWriter::CssWriter() {
-  out = NULL;
-  column = 0;
-  sourcemap = NULL;
+  init(NULL, NULL);
 }
 
-CssWriter::CssWriter(std::ostream &out): out(&out), column(0) {
-  sourcemap = NULL;
+CssWriter::CssWriter(std::ostream &out) {
+  init(new StreamOutputSink(out), NULL);
+  ownsSink = true;
+}
+CssWriter::CssWriter(std::ostream &out, SourceMapWriter &sourcemap) {
+  init(new StreamOutputSink(out), &sourcemap);
+  ownsSink = true;
 }
-CssWriter::CssWriter(std::ostream &out, SourceMapWriter &sourcemap):
-  out(&out), column(0), sourcemap(&sourcemap) {
+CssWriter::CssWriter(OutputSink &sink) {
+  init(&sink, NULL);
+}
+CssWriter::CssWriter(OutputSink &sink, SourceMapWriter &sourcemap) {
+  init(&sink, &sourcemap);
+}
+
+void CssWriter::init(OutputSink* sink, SourceMapWriter* sourcemap) {
+  this->sink = sink;
+  this->sourcemap = sourcemap;
+  ownsSink = false;
+  column = 0;
+  buffer = new char[BUFFER_SIZE];
+  bufferLength = 0;
 }
 
 CssWriter::~CssWriter() {
+  if (ownsSink)
+    delete sink;
+  delete [] buffer;
 }
 
 unsigned int CssWriter::getColumn() {
   return column;
 }
 
+void CssWriter::flushBuffer() {
+  if (bufferLength > 0) {
+    sink->write(buffer, bufferLength);
+    bufferLength = 0;
+  }
+}
+
+void CssWriter::flush() {
+  flushBuffer();
+  sink->flush();
+}
+
 void CssWriter::writeStr(const char* str, size_t len) {
-  out->write(str, len);
   column += len;
+
+  if (bufferLength + len > BUFFER_SIZE) {
+    flushBuffer();
+
+    if (len >= BUFFER_SIZE) {
+      sink->write(str, len);
+      return;
+    }
+  }
+  std::memcpy(buffer + bufferLength, str, len);
+  bufferLength += len;
 }
 void CssWriter::writeToken(const Token &token) {
   std::string url;
@@ -116,6 +156,19 @@ void CssWriter::writeValue(const TokenList &value) {
   }
 }
 
+void CssWriter::writeDeclarationValue(const Token &property,
+                                      const TokenList &value) {
+  TokenList minified;
+  
+  if (minifier == NULL) {
+    writeValue(value);
+    return;
+  }
+  minified = value;
+  minifier->minify(property, minified);
+  writeValue(minified);
+}
+
 void CssWriter::writeAtRule(const Token &keyword, const TokenList &rule) {
   if (sourcemap != NULL)
     sourcemap->writeMapping(column, keyword);
@@ -149,7 +202,7 @@ void CssWriter::writeDeclaration(const Token &property, const TokenList &value)
   writeToken(property);
   writeStr(":", 1);
 
-  writeValue(value);
+  writeDeclarationValue(property, value);
 }
 
 void CssWriter::writeDeclarationDeliminator() {
@@ -160,6 +213,23 @@ void CssWriter::writeComment(const Token &comment) {
   writeToken(comment);
 }
 
+void CssWriter::writeInlineCss(const char* css, size_t len) {
+  size_t i, linestart = 0;
+
+  writeStr(css, len);
+
+  // The source map has no mappings for the css, only its lines.
+  for (i = 0; i < len; i++) {
+    if (css[i] == '\n') {
+      if (sourcemap != NULL)
+        sourcemap->writeNewline();
+      linestart = i + 1;
+    }
+  }
+  if (linestart > 0)
+    column = len - linestart;
+}
+
 void CssWriter::writeMediaQueryStart(const TokenList &selector) {
   writeSelector(selector);
   writeStr("{", 1);
@@ -170,6 +240,7 @@ void CssWriter::writeMediaQueryEnd() {
 }
 
 void CssWriter::writeSourceMapUrl(const char* sourcemap_url) {
-  *out << std::endl << "/*# sourceMappingURL=" <<
-    sourcemap_url << " */" << std::endl;
+  writeStr("\n/*# sourceMappingURL=", 22);
+  writeStr(sourcemap_url, std::strlen(sourcemap_url));
+  writeStr(" */\n", 4);
 }
@@ -24,12 +24,27 @@
 
 #include "../TokenList.h"
 #include "SourceMapWriter.h"
+#include "OutputSink.h"
+#include "ValueMinifier.h"
 #include <iostream>
 #include <cstring>
 
 class CssWriter {
+private:
+  /**
+   * Output is collected in the buffer and written to the sink when
+   * the buffer is full.
+   */
+  static const size_t BUFFER_SIZE = 65536;
+  char* buffer;
+  size_t bufferLength;
+  bool ownsSink;
+
+  void init(OutputSink* sink, SourceMapWriter* sourcemap);
+  void flushBuffer();
+
 protected:
-  std::ostream* out;
+  OutputSink* sink;
   unsigned int column;
   SourceMapWriter* sourcemap;
 
@@ -39,16 +54,32 @@ protected:
   
   virtual void writeSelector(const TokenList &selector);
   virtual void writeValue(const TokenList &value);
+  /**
+   * Write the value of a declaration, minified if there is a
+   * minifier.
+   */
+  void writeDeclarationValue(const Token &property,
+                             const TokenList &value);
   
 public:
   CssWriter();
   CssWriter(std::ostream &out);
   CssWriter(std::ostream &out,
             SourceMapWriter &sourcemap);
+  CssWriter(OutputSink &sink);
+  CssWriter(OutputSink &sink, SourceMapWriter &sourcemap);
 
   const char* rootpath = NULL;
+  ValueMinifier* minifier = NULL;
   
   unsigned int getColumn();
+
+  /**
+   * Write the buffered output to the sink. Call this before the writer
+   * is deleted; the destructor does not flush, so that write errors
+   * can be reported.
+   */
+  void flush();
   
   virtual ~CssWriter();
   virtual void writeAtRule(const Token &keyword, const TokenList &rule);
@@ -57,6 +88,10 @@ public:
   virtual void writeDeclaration(const Token &property, const TokenList &value);
   virtual void writeDeclarationDeliminator();
   virtual void writeComment(const Token &comment);
+  /**
+   * Write CSS that was not parsed, like an (inline) import.
+   */
+  virtual void writeInlineCss(const char* css, size_t len);
   virtual void writeMediaQueryStart(const TokenList &selector);
   virtual void writeMediaQueryEnd();
 
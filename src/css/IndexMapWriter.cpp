@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "IndexMapWriter.h"
+#include "SourceMapWriter.h"
+
+IndexMapWriter::IndexMapWriter(std::ostream &indexmap,
+                               const char* out_filename):
+  indexmap_h(indexmap) {
+  sections = 0;
+  
+  indexmap_h << "{";
+  indexmap_h << "\"version\" : 3,";
+  indexmap_h << "\"file\": ";
+  SourceMapWriter::writeString(indexmap_h, out_filename);
+  indexmap_h << ",";
+  indexmap_h << "\"sections\": [";
+}
+
+IndexMapWriter::~IndexMapWriter() {
+}
+
+void IndexMapWriter::writeSection(unsigned int line, unsigned int column,
+                                  const std::string &sourcemap) {
+  size_t length = sourcemap.find_last_not_of(" \t\r\n");
+
+  if (sections++ > 0)
+    indexmap_h << ",";
+
+  indexmap_h << "{\"offset\": {\"line\": " << line <<
+    ", \"column\": " << column << "}, \"map\": ";
+  
+  if (length == std::string::npos)
+    indexmap_h << "null";
+  else
+    indexmap_h.write(sourcemap.data(), length + 1);
+  indexmap_h << "}";
+}
+
+void IndexMapWriter::close() {
+  indexmap_h << "]}" << std::endl;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __IndexMapWriter_h__
+#define __IndexMapWriter_h__
+
+#include <iostream>
+#include <string>
+
+/**
+ * Writes an index source map, which composes the source maps of
+ * several outputs that are concatenated into one file. Each map is
+ * copied into a section with the line and column where its output
+ * starts, so the mappings are not decoded and encoded again.
+ */
+class IndexMapWriter {
+private:
+  std::ostream &indexmap_h;
+  unsigned int sections;
+  
+public:
+  IndexMapWriter(std::ostream &indexmap, const char* out_filename);
+  virtual ~IndexMapWriter();
+
+  /**
+   * Add the source map of an output that starts at the given line and
+   * column of the concatenated file. Sections have to be added in
+   * the order of the output.
+   */
+  void writeSection(unsigned int line, unsigned int column,
+                    const std::string &sourcemap);
+
+  void close();
+};
+  
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "OutputSink.h"
+#include "IOException.h"
+
+#include <unistd.h>
+#include <cerrno>
+
+StreamOutputSink::StreamOutputSink(std::ostream &out): out(out) {
+}
+
+StreamOutputSink::~StreamOutputSink() {
+}
+
+void StreamOutputSink::write(const char* data, size_t length) {
+  out.write(data, length);
+}
+
+void StreamOutputSink::flush() {
+  out.flush();
+}
+
+FdOutputSink::FdOutputSink(int fd): fd(fd) {
+}
+
+FdOutputSink::~FdOutputSink() {
+}
+
+void FdOutputSink::write(const char* data, size_t length) {
+  ssize_t written;
+  
+  while (length > 0) {
+    written = ::write(fd, data, length);
+
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      throw new IOException("Error writing output");
+    }
+    data += written;
+    length -= written;
+  }
+}
+
+CountingOutputSink::CountingOutputSink(): count(0) {
+}
+
+CountingOutputSink::~CountingOutputSink() {
+}
+
+void CountingOutputSink::write(const char* data, size_t length) {
+  (void)data;
+  count += length;
+}
+
+size_t CountingOutputSink::getCount() const {
+  return count;
+}
+
+TeeOutputSink::TeeOutputSink(OutputSink &first, OutputSink &second):
+  first(first), second(second) {
+}
+
+TeeOutputSink::~TeeOutputSink() {
+}
+
+void TeeOutputSink::write(const char* data, size_t length) {
+  first.write(data, length);
+  second.write(data, length);
+}
+
+void TeeOutputSink::flush() {
+  first.flush();
+  second.flush();
+}
+
+void TeeOutputSink::close() {
+  first.close();
+  second.close();
+}
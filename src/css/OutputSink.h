@@ -0,0 +1,102 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __OutputSink_h__
+#define __OutputSink_h__
+
+#include <iostream>
+#include <cstddef>
+
+/**
+ * The destination of the CSS output. CssWriter collects its output
+ * in a buffer and hands it to the sink in large blocks.
+ */
+class OutputSink {
+public:
+  virtual ~OutputSink() {};
+  virtual void write(const char* data, size_t length) = 0;
+  virtual void flush() {};
+  /**
+   * Called once after the last write, for sinks that have to finish
+   * their output.
+   */
+  virtual void close() {};
+};
+
+/**
+ * Writes the output to an ostream, for example std::cout.
+ */
+class StreamOutputSink: public OutputSink {
+private:
+  std::ostream &out;
+  
+public:
+  StreamOutputSink(std::ostream &out);
+  virtual ~StreamOutputSink();
+  virtual void write(const char* data, size_t length);
+  virtual void flush();
+};
+
+/**
+ * Writes the output directly to a file descriptor, bypassing
+ * iostreams. The file descriptor is not closed by the sink.
+ */
+class FdOutputSink: public OutputSink {
+private:
+  int fd;
+  
+public:
+  FdOutputSink(int fd);
+  virtual ~FdOutputSink();
+  virtual void write(const char* data, size_t length);
+};
+
+/**
+ * Discards the output and only counts the number of bytes.
+ */
+class CountingOutputSink: public OutputSink {
+private:
+  size_t count;
+  
+public:
+  CountingOutputSink();
+  virtual ~CountingOutputSink();
+  virtual void write(const char* data, size_t length);
+  size_t getCount() const;
+};
+
+/**
+ * Writes the output to two sinks.
+ */
+class TeeOutputSink: public OutputSink {
+private:
+  OutputSink &first;
+  OutputSink &second;
+  
+public:
+  TeeOutputSink(OutputSink &first, OutputSink &second);
+  virtual ~TeeOutputSink();
+  virtual void write(const char* data, size_t length);
+  virtual void flush();
+  virtual void close();
+};
+
+#endif
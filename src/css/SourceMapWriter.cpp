@@ -24,7 +24,7 @@
 const char* SourceMapWriter::base64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
 SourceMapWriter::SourceMapWriter(std::ostream &sourcemap,
-                                 std::list<const char*> &sources,
+                                 SourceList &sources,
                                  const char* out_filename,
                                  const char* rootpath,
                                  const char* basepath):
@@ -33,6 +33,8 @@ SourceMapWriter::SourceMapWriter(std::ostream &sourcemap,
   lastSrcFile = 0;
   lastSrcLine = 0;
   lastSrcColumn = 0;
+  lines = 0;
+  mappings.reserve(4096);
   writePreamble(out_filename, rootpath, basepath);
 }
 
@@ -44,7 +46,7 @@ SourceMapWriter::~SourceMapWriter() {
 void SourceMapWriter::writePreamble(const char* out_filename,
                                     const char* rootpath,
                                     const char* basepath) {
-  std::list<const char*>::iterator it;
+  SourceList::const_iterator it;
   const char* source;
   size_t bp_l = 0;
   
@@ -56,13 +58,15 @@ void SourceMapWriter::writePreamble(const char* out_filename,
   sourcemap_h << "\"version\" : 3,";
 
   if (rootpath != NULL) {
-    sourcemap_h << "\"sourceRoot\": \"" <<
-      rootpath << "\",";
+    sourcemap_h << "\"sourceRoot\": ";
+    writeString(sourcemap_h, rootpath);
+    sourcemap_h << ",";
   }
   
   sourcemap_h << "\"file\": ";
 
-  sourcemap_h << "\"" << out_filename << "\",";
+  writeString(sourcemap_h, out_filename);
+  sourcemap_h << ",";
   
   sourcemap_h << "\"sources\": [";
 
@@ -75,47 +79,116 @@ void SourceMapWriter::writePreamble(const char* out_filename,
         strncmp(source, basepath, bp_l) == 0) {
       source += bp_l;
     }
-    sourcemap_h << "\"" << source << "\"";
+    writeString(sourcemap_h, source);
   }
 
   sourcemap_h << "],";
 
+  if (sources.isKeepingContents())
+    writeSourcesContent();
+
+  // The output is not mapped back to less variable or mixin names.
   sourcemap_h << "\"names\": [],";
   sourcemap_h << "\"mappings\": \"";
 }
 
+void SourceMapWriter::writeSourcesContent() {
+  SourceList::const_iterator it;
+  std::string* content;
+
+  sourcemap_h << "\"sourcesContent\": [";
+
+  for (it = sources.begin(); it != sources.end(); it++) {
+    if (it != sources.begin())
+      sourcemap_h << ",";
+
+    if ((content = sources.getContent(*it)) != NULL)
+      writeString(sourcemap_h, *content);
+    else
+      sourcemap_h << "null";
+  }
+  sourcemap_h << "],";
+}
+
+void SourceMapWriter::writeString(std::ostream &out, const std::string &str) {
+  static const char* hex = "0123456789abcdef";
+  const char* data = str.data();
+  size_t i, start = 0;
+  char escape[6] = {'\\', 'u', '0', '0', '0', '0'};
+  unsigned char c;
+
+  out.put('"');
+
+  // write the unescaped characters in runs
+  for (i = 0; i < str.size(); i++) {
+    c = data[i];
+    if (c >= 0x20 && c != '"' && c != '\\')
+      continue;
+
+    out.write(data + start, i - start);
+    start = i + 1;
+    
+    switch (c) {
+    case '"':
+      out.write("\\\"", 2);
+      break;
+    case '\\':
+      out.write("\\\\", 2);
+      break;
+    case '\n':
+      out.write("\\n", 2);
+      break;
+    case '\r':
+      out.write("\\r", 2);
+      break;
+    case '\t':
+      out.write("\\t", 2);
+      break;
+    default:
+      escape[4] = hex[c >> 4];
+      escape[5] = hex[c & 0xF];
+      out.write(escape, 6);
+    }
+  }
+  out.write(data + start, i - start);
+  out.put('"');
+}
+
 void SourceMapWriter::close() {
+  sourcemap_h.write(mappings.data(), mappings.size());
+  mappings.clear();
   sourcemap_h << "\"}" << std::endl;
 }
 
 
 void SourceMapWriter::writeMapping(unsigned int column, const Token& source) {
-  char buffer[10];
-  size_t len = encodeMapping(column, source, buffer);
-
-  sourcemap_h.write(buffer, len);
-  sourcemap_h.write(",", 1);
+  // 4 fields of at most 7 characters and the separator.
+  size_t pos = mappings.size();
+  size_t srcFileIndex = sources.indexOf(source.source);
+
+  // tokens created by the compiler have no source to map to
+  if (srcFileIndex == SourceList::NOT_FOUND)
+    return;
+
+  mappings.resize(pos + 29);
+  pos += encodeMapping(column, srcFileIndex, source, &mappings[pos]);
+  mappings[pos++] = ',';
+  mappings.resize(pos);
 }
 
 void SourceMapWriter::writeNewline() {
-  sourcemap_h.write(";", 1);
+  mappings.push_back(';');
   lastDstColumn = 0;
+  lines++;
 }
 
-size_t SourceMapWriter::sourceFileIndex(const char* file) {
-  std::list<const char*>::iterator i;
-  size_t pos = 0;
-  
-  for (i = sources.begin(); i != sources.end(); i++, pos++) {
-    if (*i == file)
-      return pos;
-  }
-  return 0;
+unsigned int SourceMapWriter::getLines() const {
+  return lines;
 }
 
 size_t SourceMapWriter::encodeMapping(unsigned int column,
+                                      unsigned int srcFileIndex,
                                       const Token &source, char* buffer) {
-  unsigned int srcFileIndex = sourceFileIndex(source.source);
   char* start = buffer;
   
   buffer += encodeField(column - lastDstColumn, buffer);
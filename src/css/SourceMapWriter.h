@@ -23,8 +23,10 @@
 #define __SourceMapWriter_h__
 
 #include "../Token.h"
+#include "../SourceList.h"
 
 #include <list>
+#include <string>
 #include <iostream>
 #include <stdlib.h>
 #include <string.h>
@@ -32,24 +34,40 @@
 class SourceMapWriter {
 private:
   std::ostream &sourcemap_h;
-  std::list<const char*> &sources;
+  SourceList &sources;
 
   unsigned int lastDstColumn;
   unsigned int lastSrcFile, lastSrcLine, lastSrcColumn;
+  unsigned int lines;
 
-  size_t sourceFileIndex(const char* file) ;
-  size_t encodeMapping(unsigned int column,
+  /**
+   * The mappings are collected here and written to the stream by
+   * close().
+   */
+  std::string mappings;
+
+  size_t encodeMapping(unsigned int column, unsigned int srcFileIndex,
                        const Token &source, char* buffer);
   size_t encodeField(int field, char* buffer);
 
+  /**
+   * Write the text of the sources, in the order of the sources list.
+   */
+  void writeSourcesContent();
+
   void writePreamble(const char* out_filename,
                      const char* rootpath = NULL,
                      const char* basepath = NULL);
 public:
   static const char* base64;
+
+  /**
+   * Write str to out as a quoted JSON string.
+   */
+  static void writeString(std::ostream &out, const std::string &str);
   
   SourceMapWriter(std::ostream &sourcemap,
-                  std::list<const char*> &sources,
+                  SourceList &sources,
                   const char* out_filename,
                   const char* rootpath = NULL,
                   const char* basepath = NULL);
@@ -58,6 +76,11 @@ public:
   void writeMapping(unsigned int column, const Token& source) ;
   void writeNewline();
 
+  /**
+   * The number of newlines in the output so far.
+   */
+  unsigned int getLines() const;
+
   void close();
 };
   
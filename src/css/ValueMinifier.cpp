@@ -0,0 +1,378 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "ValueMinifier.h"
+#include "../value/ColorNames.h"
+#include "../value/UnitRegistry.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <vector>
+
+/**
+ * Font family names that have to stay quoted.
+ */
+static const char* FONT_KEYWORDS[] = {
+  "serif", "sans-serif", "cursive", "fantasy", "monospace",
+  "system-ui", "emoji", "math", "fangsong", "ui-serif",
+  "ui-sans-serif", "ui-monospace", "ui-rounded", "inherit", "initial",
+  "unset", "revert", "default", NULL
+};
+
+ValueMinifier::ValueMinifier() {
+}
+
+ValueMinifier::~ValueMinifier() {
+}
+
+void ValueMinifier::minify(const Token &property, TokenList &value) {
+  TokenList::iterator i;
+  // the enclosing functions, "" for plain parentheses.
+  std::vector<std::string> functions;
+  const Token* previous = NULL;
+  const Token* last = NULL;
+  size_t math = 0;
+  bool keepUnits, colors, fonts;
+
+  // custom properties can be used anywhere
+  if (property.compare(0, 2, "--") == 0)
+    return;
+
+  keepUnits = (property.find("flex") != std::string::npos);
+  colors = isColorProperty(property);
+  fonts = (property == "font-family");
+  
+  for (i = value.begin(); i != value.end(); i++) {
+    switch ((*i).type) {
+    case Token::PAREN_OPEN:
+      if (last != NULL && last->type == Token::IDENTIFIER)
+        functions.push_back(*last);
+      else
+        functions.push_back("");
+      if (isMathFunction(functions.back()))
+        math++;
+      break;
+      
+    case Token::PAREN_CLOSED:
+      if (!functions.empty()) {
+        if (isMathFunction(functions.back()))
+          math--;
+        functions.pop_back();
+      }
+      break;
+      
+    case Token::NUMBER:
+    case Token::PERCENTAGE:
+    case Token::DIMENSION:
+      minifyNumber(*i, keepUnits || math > 0);
+      break;
+
+    case Token::HASH:
+      // filter: progid:...(startColorstr=#...) needs the full color
+      if (previous == NULL || *previous != "=")
+        minifyHash(*i);
+      break;
+
+    case Token::IDENTIFIER:
+      if (colors && functions.empty())
+        minifyColorName(*i);
+      break;
+      
+    case Token::URL:
+      minifyUrl(*i);
+      break;
+
+    case Token::STRING:
+      if (fonts)
+        minifyFontName(*i);
+      break;
+      
+    default:
+      break;
+    }
+
+    last = &(*i);
+    if ((*i).type != Token::WHITESPACE)
+      previous = &(*i);
+  }
+
+  removeWhitespace(value);
+
+  if (property == "font-weight" && !value.empty() &&
+      (value.size() == 1 || *(++value.begin()) == "!")) {
+    if (value.front() == "normal") 
+      value.front().assign("400");
+    else if (value.front() == "bold")
+      value.front().assign("700");
+    else
+      return;
+    value.front().type = Token::NUMBER;
+  }
+}
+
+void ValueMinifier::minifyNumber(Token &token, bool keepUnit) {
+  size_t pos = 0, start, end, digits;
+  std::string sign, integer, fraction, unit;
+
+  if (token[pos] == '-' || token[pos] == '+') {
+    if (token[pos] == '-')
+      sign = "-";
+    pos++;
+  }
+  
+  start = pos;
+  while (pos < token.size() && isdigit(token[pos]))
+    pos++;
+  end = pos;
+  digits = end - start;
+  
+  // leading zeros
+  while (start < end && token[start] == '0')
+    start++;
+  integer = token.substr(start, end - start);
+
+  if (pos < token.size() && token[pos] == '.') {
+    start = ++pos;
+    while (pos < token.size() && isdigit(token[pos]))
+      pos++;
+    end = pos;
+    digits += end - start;
+    
+    // trailing zeros
+    while (end > start && token[end - 1] == '0')
+      end--;
+    fraction = token.substr(start, end - start);
+  }
+  
+  if (digits == 0)
+    return;
+  
+  unit = token.substr(pos);
+  
+  // exponent
+  if (unit.size() > 1 && (unit[0] == 'e' || unit[0] == 'E') &&
+      (isdigit(unit[1]) || unit[1] == '-' || unit[1] == '+'))
+    return;
+
+  if (integer.empty() && fraction.empty()) {
+    if (token.type == Token::DIMENSION && !keepUnit && isLength(unit)) {
+      token.assign("0");
+      token.type = Token::NUMBER;
+    } else
+      token.assign("0" + unit);
+    
+  } else if (fraction.empty())
+    token.assign(sign + integer + unit);
+  else
+    token.assign(sign + integer + "." + fraction + unit);
+}
+
+void ValueMinifier::minifyHash(Token &token) {
+  std::string hex;
+  unsigned int rgb;
+  size_t i;
+  const char* name;
+
+  if (token.size() != 4 && token.size() != 5 &&
+      token.size() != 7 && token.size() != 9)
+    return;
+  
+  for (i = 1; i < token.size(); i++) {
+    if (!isxdigit(token[i]))
+      return;
+    hex.push_back(tolower(token[i]));
+  }
+
+  if (hex.size() > 4 &&
+      hex[0] == hex[1] && hex[2] == hex[3] && hex[4] == hex[5] &&
+      (hex.size() == 6 || hex[6] == hex[7])) {
+    hex = hex.size() == 6 ?
+      std::string() + hex[0] + hex[2] + hex[4] :
+      std::string() + hex[0] + hex[2] + hex[4] + hex[6];
+  }
+
+  if (hex.size() == 3) {
+    rgb = strtoul(hex.c_str(), NULL, 16);
+    name = ColorNames::getShortName(((rgb >> 8) & 0xF) * 0x11,
+                                    ((rgb >> 4) & 0xF) * 0x11,
+                                    (rgb & 0xF) * 0x11);
+  } else if (hex.size() == 6) {
+    rgb = strtoul(hex.c_str(), NULL, 16);
+    name = ColorNames::getShortName((rgb >> 16) & 0xFF,
+                                    (rgb >> 8) & 0xFF,
+                                    rgb & 0xFF);
+  } else
+    name = NULL;
+
+  if (name != NULL && strlen(name) <= hex.size()) {
+    token.assign(name);
+    token.type = Token::IDENTIFIER;
+  } else
+    token.assign("#" + hex);
+}
+
+void ValueMinifier::minifyColorName(Token &token) {
+  const ColorNames::ColorName* color = ColorNames::find(token);
+  char hex[8];
+
+  // transparent has no hexadecimal notation without alpha
+  if (color == NULL || color->alpha == 0)
+    return;
+
+  if ((color->red >> 4) == (color->red & 0xF) &&
+      (color->green >> 4) == (color->green & 0xF) &&
+      (color->blue >> 4) == (color->blue & 0xF)) {
+    snprintf(hex, sizeof(hex), "#%x%x%x", color->red & 0xF,
+             color->green & 0xF, color->blue & 0xF);
+  } else {
+    snprintf(hex, sizeof(hex), "#%02x%02x%02x", color->red,
+             color->green, color->blue);
+  }
+  
+  if (strlen(hex) < token.size()) {
+    token.assign(hex);
+    token.type = Token::HASH;
+  }
+}
+
+void ValueMinifier::minifyUrl(Token &token) {
+  std::string url = token.getUrlString();
+
+  if (url.empty() ||
+      url.find_first_of(" \t\r\n\f\"'()\\") != std::string::npos)
+    return;
+
+  if (url.size() + 5 < token.size())
+    token.assign("url(" + url + ")");
+}
+
+void ValueMinifier::minifyFontName(Token &token) {
+  std::string name = token;
+  size_t start = 0, end;
+  const char** keyword;
+  std::string word;
+
+  token.removeQuotes(name);
+  if (name.size() + 2 != token.size())
+    return;
+
+  do {
+    end = name.find(' ', start);
+    word = name.substr(start, end == std::string::npos ?
+                       std::string::npos : end - start);
+    if (!isIdentifier(word))
+      return;
+
+    for (keyword = FONT_KEYWORDS; *keyword != NULL; keyword++) {
+      if (strcasecmp(word.c_str(), *keyword) == 0)
+        return;
+    }
+    start = end + 1;
+  } while (end != std::string::npos);
+
+  token.assign(name);
+  token.type = Token::IDENTIFIER;
+}
+
+void ValueMinifier::removeWhitespace(TokenList &value) {
+  TokenList::iterator i, next;
+  const Token* previous = NULL;
+
+  value.trim();
+  
+  i = value.begin();
+  while (i != value.end()) {
+    if ((*i).type != Token::WHITESPACE) {
+      previous = &(*i);
+      i++;
+      continue;
+    }
+    
+    next = i;
+    next++;
+
+    // Whitespace is not needed after '(', ',' and '/', or before ')',
+    // ',', '/' and '!important'.
+    if (previous == NULL ||
+        previous->type == Token::PAREN_OPEN ||
+        *previous == "," || *previous == "/" ||
+        next == value.end() ||
+        (*next).type == Token::WHITESPACE ||
+        (*next).type == Token::PAREN_CLOSED ||
+        *next == "," || *next == "/" || *next == "!") {
+      i = value.erase(i);
+    } else {
+      if (*i != " ")
+        (*i).assign(" ");
+      i++;
+    }
+  }
+}
+
+bool ValueMinifier::isMathFunction(const std::string &function) {
+  return (function == "min" ||
+          function == "max" ||
+          function == "clamp" ||
+          function == "var" ||
+          function == "env" ||
+          (function.size() >= 4 &&
+           function.compare(function.size() - 4, 4, "calc") == 0));
+}
+
+bool ValueMinifier::isColorProperty(const std::string &property) {
+  return (property.find("color") != std::string::npos ||
+          property == "background" ||
+          property.compare(0, 6, "border") == 0 ||
+          property.compare(0, 7, "outline") == 0 ||
+          property == "box-shadow" ||
+          property == "text-shadow" ||
+          property == "fill" ||
+          property == "stroke");
+}
+
+bool ValueMinifier::isLength(const std::string &unit) {
+  UnitRegistry::Unit u = UnitRegistry::findUnit(unit);
+  
+  return (UnitRegistry::getUnitGroup(u) == UnitRegistry::LENGTH ||
+          (u >= UnitRegistry::EM && u <= UnitRegistry::VMAX));
+}
+
+bool ValueMinifier::isIdentifier(const std::string &word) {
+  std::string::const_iterator i = word.begin();
+
+  if (i == word.end())
+    return false;
+  if (*i == '-')
+    i++;
+  if (i == word.end() ||
+      !(isalpha(*i) || *i == '_' || (unsigned char)*i >= 0x80))
+    return false;
+  
+  for (; i != word.end(); i++) {
+    if (!(isalnum(*i) || *i == '-' || *i == '_' ||
+          (unsigned char)*i >= 0x80))
+      return false;
+  }
+  return true;
+}
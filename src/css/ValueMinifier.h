@@ -0,0 +1,61 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __ValueMinifier_h__
+#define __ValueMinifier_h__
+
+#include "../Token.h"
+#include "../TokenList.h"
+
+#include <string>
+
+/**
+ * Rewrites declaration values to their shortest form: numbers lose
+ * leading and trailing zeros, zero lengths lose their unit, colors
+ * use the shortest notation, font weights are numeric, whitespace is
+ * removed where it is not needed and quotes are removed from urls and
+ * font names where that is safe.
+ */
+class ValueMinifier {
+private:
+  void minifyNumber(Token &token, bool keepUnit);
+  void minifyHash(Token &token);
+  void minifyColorName(Token &token);
+  void minifyUrl(Token &token);
+  void minifyFontName(Token &token);
+  void removeWhitespace(TokenList &value);
+
+  /**
+   * calc() and friends need the unit on zero lengths.
+   */
+  bool isMathFunction(const std::string &function);
+  bool isColorProperty(const std::string &property);
+  bool isLength(const std::string &unit);
+  bool isIdentifier(const std::string &word);
+  
+public:
+  ValueMinifier();
+  virtual ~ValueMinifier();
+
+  virtual void minify(const Token &property, TokenList &value);
+};
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+
+#include "ImportCache.h"
+
+#include <cstring>
+
+CachedImport::CachedImport(const std::string &filename, bool isreference) {
+  this->filename = new char[filename.length() + 1];
+  std::strcpy(this->filename, filename.c_str());
+  reference = isreference;
+  shareable = true;
+  borrower = NULL;
+
+  sources.setKeepContents(true);
+  sources.addSource(this->filename);
+}
+
+CachedImport::~CachedImport() {
+  delete [] filename;
+}
+
+const char* CachedImport::getFilename() const {
+  return filename;
+}
+bool CachedImport::isReference() const {
+  return reference;
+}
+
+void CachedImport::setShareable(bool shareable) {
+  this->shareable = shareable;
+}
+bool CachedImport::isShareable() const {
+  return shareable;
+}
+
+SourceList& CachedImport::getSources() {
+  return sources;
+}
+const std::list<CachedImport::Action>& CachedImport::getActions() const {
+  return actions;
+}
+
+void CachedImport::addImport(const Token &uri, const TokenList &media,
+                             unsigned int directive) {
+  Action a;
+
+  a.import = true;
+  a.token = uri;
+  a.value = media;
+  a.directive = directive;
+  a.position = getStatements().size();
+  actions.push_back(a);
+}
+
+void CachedImport::putVariable(const std::string &key,
+                               const SharedTokenList &value) {
+  Action a;
+
+  a.import = false;
+  a.token = key;
+  a.value = value;
+  a.directive = 0;
+  a.position = getStatements().size();
+  actions.push_back(a);
+}
+
+void CachedImport::setBorrower(LessStylesheet &stylesheet) {
+  borrower = &stylesheet;
+}
+
+void CachedImport::clearBorrower() {
+  borrower = NULL;
+}
+
+void CachedImport::getLessRulesets(std::list<LessRuleset*> &rulesetList,
+                                   const Mixin &mixin) {
+  if (borrower != NULL)
+    borrower->getLessRulesets(rulesetList, mixin);
+  else
+    LessStylesheet::getLessRulesets(rulesetList, mixin);
+}
+
+ProcessingContext* CachedImport::getContext() {
+  return (borrower != NULL) ? borrower->getContext() :
+    LessStylesheet::getContext();
+}
+
+ImportCache::~ImportCache() {
+  std::map<std::string, CachedImport*>::iterator i;
+
+  for (i = imports.begin(); i != imports.end(); i++) {
+    if (i->second != NULL)
+      delete i->second;
+  }
+}
+
+std::string ImportCache::getKey(const std::string &filename,
+                                bool isreference) const {
+  return isreference ? "(reference)" + filename : filename;
+}
+
+bool ImportCache::find(const std::string &filename, bool isreference,
+                       CachedImport* &import) const {
+  std::map<std::string, CachedImport*>::const_iterator i =
+    imports.find(getKey(filename, isreference));
+
+  if (i == imports.end())
+    return false;
+  import = i->second;
+  return true;
+}
+
+void ImportCache::put(const std::string &filename, bool isreference,
+                      CachedImport* import) {
+  imports[getKey(filename, isreference)] = import;
+}
+
+void ImportCache::clearBorrowers() {
+  std::map<std::string, CachedImport*>::iterator i;
+
+  for (i = imports.begin(); i != imports.end(); i++) {
+    if (i->second != NULL)
+      i->second->clearBorrower();
+  }
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+
+#ifndef __ImportCache_h__
+#define __ImportCache_h__
+
+#include "../lessstylesheet/LessStylesheet.h"
+#include "../SharedTokenList.h"
+#include "../SourceList.h"
+#include "../Token.h"
+
+#include <list>
+#include <map>
+#include <string>
+
+/**
+ * A parsed .less file that is shared by the stylesheets that import
+ * it. The statements stay owned by the import and are borrowed by each
+ * stylesheet. The variables and the imports of the file are recorded
+ * in order, so they can be done again in every stylesheet that
+ * imports it; that way the once directive and variable overrides work
+ * as if the file was parsed into that stylesheet.
+ *
+ * Mixin lookups and the processing context of the statements go to the
+ * current borrower, the stylesheet that borrowed them last. Stylesheets
+ * that share an import must therefore be processed one at a time.
+ */
+class CachedImport: public LessStylesheet {
+public:
+  struct Action {
+    bool import;
+    /**
+     * The uri of an import, or the name of a variable.
+     */
+    Token token;
+    /**
+     * The media list of an import, or the value of a variable.
+     */
+    SharedTokenList value;
+    unsigned int directive;
+    /**
+     * The number of statements before an import.
+     */
+    size_t position;
+  };
+
+private:
+  char* filename;
+  bool reference;
+  bool shareable;
+  SourceList sources;
+  std::list<Action> actions;
+  LessStylesheet* borrower;
+  
+public:
+  CachedImport(const std::string &filename, bool isreference);
+  virtual ~CachedImport();
+
+  const char* getFilename() const;
+  bool isReference() const;
+
+  void setShareable(bool shareable);
+  bool isShareable() const;
+
+  /**
+   * The sources list used while parsing the file. The content of the
+   * file is kept in it.
+   */
+  SourceList& getSources();
+  const std::list<Action>& getActions() const;
+
+  void addImport(const Token &uri, const TokenList &media,
+                 unsigned int directive);
+  virtual void putVariable(const std::string &key,
+                           const SharedTokenList &value);
+
+  void setBorrower(LessStylesheet &stylesheet);
+  void clearBorrower();
+  
+  virtual void getLessRulesets(std::list<LessRuleset*> &rulesetList,
+                               const Mixin &mixin);
+  virtual ProcessingContext* getContext();
+};
+
+/**
+ * The .less files that were imported so far, by file name and
+ * reference directive.
+ */
+class ImportCache {
+private:
+  std::map<std::string, CachedImport*> imports;
+
+  std::string getKey(const std::string &filename, bool isreference) const;
+  
+public:
+  virtual ~ImportCache();
+
+  /**
+   * Look up a file. Returns false if the file has not been imported
+   * yet, otherwise import is set to the parsed file, or to NULL if the
+   * file can't be shared.
+   */
+  bool find(const std::string &filename, bool isreference,
+            CachedImport* &import) const;
+
+  /**
+   * Add a parsed file, or NULL if the file can't be shared. The cache
+   * takes ownership of the import.
+   */
+  void put(const std::string &filename, bool isreference,
+           CachedImport* import);
+
+  /**
+   * Clear the borrower of each file. Has to be called when the
+   * stylesheet that imported them is done.
+   */
+  void clearBorrowers();
+};
+
+#endif
@@ -28,6 +28,9 @@
 
 #include <libgen.h>
 
+static const Token BUILTIN_AND("and", Token::IDENTIFIER, 0, 0,
+                               Token::BUILTIN_SOURCE);
+
 /**
  * Only allows LessStylesheets
  */
@@ -437,7 +440,11 @@ bool LessParser::parseImportStatement(TokenList &statement, LessStylesheet &styl
   if (statement.size() > 0 &&
       (statement.front().type == Token::URL ||
        statement.front().type == Token::STRING)) {
-    return importFile(statement.front(), stylesheet, directive);
+    TokenList media(statement);
+
+    media.pop_front();
+    media.trim();
+    return importFile(statement.front(), media, stylesheet, directive);
         
   } else
     throw new ParseException(statement, "A string with the file path, "
@@ -467,14 +474,16 @@ unsigned int LessParser::parseImportDirective(Token &t) {
 }
 
 bool LessParser::importFile(Token uri,
+                            const TokenList &media,
                             LessStylesheet &stylesheet,
                             unsigned int directive) {
   size_t pathend;
   size_t extension_pos;
-  std::list<const char*>::iterator i;
   std::string relative_filename;
   char* relative_filename_cpy;
   std::string extension;
+  Token original = uri;
+  CachedImport* cached = NULL;
     
   if (uri.type == Token::URL) {
     uri = uri.getUrlString();
@@ -503,14 +512,26 @@ bool LessParser::importFile(Token uri,
   } else
     extension = uri.substr(extension_pos + 1, pathend);
   
-  // don't import css, unless specified with directive
+  // don't import css, unless specified with directive or css is
+  // bundled
   // don't import if css directive is given
   if ((extension == "css" &&
-       !(directive & IMPORT_LESS)) ||
+       !(directive & (IMPORT_LESS | IMPORT_INLINE)) &&
+       !bundleCss) ||
       (directive & IMPORT_CSS)) {
     return false;
   }
 
+  // The imports of a cached file are done by each stylesheet that
+  // imports it.
+  if (cachedImport != NULL) {
+    if (&stylesheet == cachedImport) {
+      cachedImport->addImport(original, media, directive);
+      return true;
+    }
+    cachedImport->setShareable(false);
+  }
+  
   if (!findFile(uri, relative_filename)) {
     if (directive & IMPORT_OPTIONAL)
       return true;
@@ -520,28 +541,59 @@ bool LessParser::importFile(Token uri,
     }
   }
 
-  if (!(directive & IMPORT_MULTIPLE)) {
-    // check if the file has already been imported.
-    for (i = sources.begin(); i != sources.end(); i++) {
-      if (relative_filename == (*i))
-        return true;
+  // check if the file has already been imported.
+  if (!(directive & IMPORT_MULTIPLE) &&
+      sources.contains(relative_filename))
+    return true;
+
+  if (importCache != NULL &&
+      !(directive & IMPORT_INLINE) &&
+      (extension != "css" || (directive & IMPORT_LESS))) {
+    if (!importCache->find(relative_filename,
+                           (directive & IMPORT_REFERENCE), cached)) {
+      cached = parseCachedImport(relative_filename,
+                                 (directive & IMPORT_REFERENCE));
+    }
+    if (cached != NULL) {
+      importCachedFile(*cached, stylesheet);
+      return true;
     }
   }
   
+  if (extension == "css" &&
+      !(directive & (IMPORT_LESS | IMPORT_INLINE))) {
+    return importCss(relative_filename, media, stylesheet,
+                     reference || (directive & IMPORT_REFERENCE));
+  }
+  
+  relative_filename_cpy = new char[relative_filename.length() + 1];
+  std::strcpy(relative_filename_cpy, relative_filename.c_str());
+              
+  sources.addSource(relative_filename_cpy);
+
+  if (directive & IMPORT_INLINE) {
+    InlineCss* css = stylesheet.createInlineCss();
+    std::string* content;
+    
+    css->load(relative_filename_cpy);
+    if ((content = sources.getContent(relative_filename_cpy)) != NULL)
+      content->assign(css->getCss(), css->getLength());
+    css->setReference(reference || (directive & IMPORT_REFERENCE));
+    return true;
+  }
+  
   ifstream in(relative_filename.c_str());
 
 #ifdef WITH_LIBGLOG
   VLOG(1) << "Opening: " << relative_filename;
 #endif
 
-  relative_filename_cpy = new char[relative_filename.length() + 1];
-  std::strcpy(relative_filename_cpy, relative_filename.c_str());
-              
-  sources.push_back(relative_filename_cpy);
   LessTokenizer tokenizer(in, relative_filename_cpy);
+  tokenizer.captureInput(sources.getContent(relative_filename_cpy));
   LessParser parser(tokenizer, sources, (directive & IMPORT_REFERENCE));
 
   parser.includePaths = includePaths;
+  parser.bundleCss = bundleCss;
   
 #ifdef WITH_LIBGLOG
   VLOG(2) << "Parsing";
@@ -552,6 +604,328 @@ bool LessParser::importFile(Token uri,
   return true;
 }
 
+CachedImport* LessParser::parseCachedImport(const std::string &filename,
+                                            bool isreference) {
+  CachedImport* import = new CachedImport(filename, isreference);
+  ifstream in(filename.c_str());
+  LessTokenizer tokenizer(in, import->getFilename());
+  LessParser parser(tokenizer, import->getSources(), isreference);
+
+  tokenizer.captureInput(import->getSources()
+                         .getContent(import->getFilename()));
+  parser.includePaths = includePaths;
+  parser.bundleCss = bundleCss;
+  parser.cachedImport = import;
+
+#ifdef WITH_LIBGLOG
+  VLOG(1) << "Parsing for the import cache: " << filename;
+#endif
+  
+  try {
+    parser.parseStylesheet(*import);
+  } catch(...) {
+    delete import;
+    throw;
+  }
+  in.close();
+
+  if (!import->isShareable()) {
+    delete import;
+    import = NULL;
+  }
+  importCache->put(filename, isreference, import);
+  return import;
+}
+
+void LessParser::importCachedFile(CachedImport &import,
+                                  LessStylesheet &stylesheet) {
+  std::list<StylesheetStatement*>& statements = import.getStatements();
+  std::list<StylesheetStatement*>::iterator s_it = statements.begin();
+  std::list<CachedImport::Action>::const_iterator a_it;
+  size_t position = 0;
+  std::string* content;
+  bool wasreference = reference;
+  TokenList rule;
+  LessAtRule* atrule;
+  
+  sources.addSource(import.getFilename());
+  if ((content = sources.getContent(import.getFilename())) != NULL)
+    content->assign(*import.getSources().getContent(import.getFilename()));
+  
+  import.setBorrower(stylesheet);
+
+  // nested imports are done as if this parser was parsing the file
+  reference = import.isReference();
+  
+  for (a_it = import.getActions().begin();
+       a_it != import.getActions().end();
+       a_it++) {
+    if ((*a_it).import) {
+      for (; position < (*a_it).position; position++, s_it++)
+        stylesheet.borrowStatement(**s_it);
+      if (!importFile((*a_it).token, *(*a_it).value, stylesheet,
+                      (*a_it).directive)) {
+        // keep the @import, as parseAtRule() does
+        rule.clear();
+        rule.push_back((*a_it).token);
+        if (!(*a_it).value->empty()) {
+          rule.push_back(Token::BUILTIN_SPACE);
+          rule.insert(rule.end(), (*a_it).value->begin(),
+                      (*a_it).value->end());
+        }
+        atrule = stylesheet.createLessAtRule(Token("@import",
+                                                   Token::ATKEYWORD,
+                                                   (*a_it).token.line,
+                                                   (*a_it).token.column,
+                                                   (*a_it).token.source));
+        atrule->setReference(reference);
+        atrule->setRule(rule);
+      }
+    } else
+      stylesheet.putVariable((*a_it).token, (*a_it).value);
+  }
+  for (; s_it != statements.end(); s_it++)
+    stylesheet.borrowStatement(**s_it);
+  
+  reference = wasreference;
+}
+
+bool LessParser::importCss(const std::string &filename,
+                           const TokenList &media,
+                           LessStylesheet &stylesheet, bool isreference) {
+  Stylesheet css;
+  std::list<StylesheetStatement*>::iterator s_it;
+  std::list<AtRule*>::iterator a_it;
+  std::list<AtRule*> imports;
+  std::string content, path;
+  std::string* sourceContent;
+  std::set<std::string> files;
+  TokenList nestedMedia;
+  MediaQuery* query;
+  Token uri;
+  bool wasreference = reference;
+  char* source = new char[filename.length() + 1];
+
+  std::strcpy(source, filename.c_str());
+
+  ifstream in(filename.c_str());
+  CssTokenizer tokenizer(in, source);
+  CssParser parser(tokenizer);
+
+  if (sources.isKeepingContents())
+    tokenizer.captureInput(&content);
+
+#ifdef WITH_LIBGLOG
+  VLOG(2) << "Bundling css: " << filename;
+#endif
+  
+  parser.parseStylesheet(css);
+  in.close();
+
+  // The imports of the file are bundled too. If one of them can't be
+  // the import of this file is left in place.
+  files.insert(filename);
+  if (!canBundleImports(css, files)) {
+#ifdef WITH_LIBGLOG
+    VLOG(1) << "Not bundling " << filename;
+#endif
+    delete [] source;
+    return false;
+  }
+  for (a_it = css.getAtRules().begin(); a_it != css.getAtRules().end();
+       a_it++) {
+    if ((*a_it)->getKeyword() == "@import")
+      imports.push_back(*a_it);
+  }
+
+  sources.addSource(source);
+  if ((sourceContent = sources.getContent(source)) != NULL)
+    sourceContent->swap(content);
+
+  path = getRebasePath(filename);
+
+  reference = isreference;
+  for (a_it = imports.begin(); a_it != imports.end(); a_it++) {
+    nestedMedia = (*a_it)->getRule();
+    uri = nestedMedia.front();
+    nestedMedia.pop_front();
+    nestedMedia.trim();
+
+    // the imported rules have to match both media lists
+    if (!media.empty() && !nestedMedia.empty()) {
+      nestedMedia.push_front(Token::BUILTIN_SPACE);
+      nestedMedia.push_front(BUILTIN_AND);
+      nestedMedia.push_front(Token::BUILTIN_SPACE);
+      nestedMedia.insert(nestedMedia.begin(), media.begin(), media.end());
+    } else if (nestedMedia.empty())
+      nestedMedia = media;
+    
+    if (importFile(uri, nestedMedia, stylesheet, 0)) {
+      css.deleteAtRule(**a_it);
+      
+    } else if (uri.type == Token::STRING && !path.empty()) {
+      // keep the import, relative to the file that is bundled
+      uri.removeQuotes();
+      (*a_it)->getRule().front().assign("\"" + path + uri + "\"");
+    }
+  }
+  reference = wasreference;
+
+  for (s_it = css.getStatements().begin();
+       s_it != css.getStatements().end(); s_it++) {
+    (*s_it)->setReference(isreference);
+  }
+  
+  rebaseUrls(css, css.getRulesets().begin(), css.getAtRules().begin(),
+             css.getMediaQueries().begin(), path);
+
+  if (media.empty()) {
+    stylesheet.appendStatements(css);
+    
+  } else if (!css.getStatements().empty()) {
+    query = stylesheet.createMediaQuery();
+    query->setReference(isreference);
+    query->getSelector().push_back(Token("@media", Token::ATKEYWORD, 0, 0,
+                                         Token::BUILTIN_SOURCE));
+    query->getSelector().push_back(Token::BUILTIN_SPACE);
+    query->getSelector().insert(query->getSelector().end(),
+                                media.begin(), media.end());
+    query->appendStatements(css);
+  }
+  return true;
+}
+
+bool LessParser::isLocalImport(const TokenList &rule) const {
+  Token uri;
+  
+  if (rule.empty())
+    return false;
+
+  uri = rule.front();
+  if (uri.type == Token::URL)
+    uri = uri.getUrlString();
+  else if (uri.type == Token::STRING)
+    uri.removeQuotes();
+  else
+    return false;
+  
+  return !uri.empty() && uri[0] != '/' &&
+    uri.find(':') == std::string::npos;
+}
+
+bool LessParser::canBundleImports(Stylesheet &css,
+                                  std::set<std::string> &files) {
+  std::list<AtRule*>::iterator a_it;
+  std::string filename;
+  Token uri;
+
+  for (a_it = css.getAtRules().begin(); a_it != css.getAtRules().end();
+       a_it++) {
+    if ((*a_it)->getKeyword() != "@import")
+      continue;
+    
+    if (!isLocalImport((*a_it)->getRule())) {
+#ifdef WITH_LIBGLOG
+      VLOG(1) << "Can't bundle remote import: " <<
+        (*a_it)->getRule().toString();
+#endif
+      return false;
+    }
+    uri = (*a_it)->getRule().front();
+    if (uri.type == Token::URL)
+      uri = uri.getUrlString();
+    else
+      uri.removeQuotes();
+
+    filename.clear();
+    if (!findFile(uri, filename)) {
+#ifdef WITH_LIBGLOG
+      VLOG(1) << "Can't bundle missing import: " << uri;
+#endif
+      return false;
+    }
+
+    // check the imports of css files once
+    if (filename.size() > 4 &&
+        filename.compare(filename.size() - 4, 4, ".css") == 0 &&
+        files.insert(filename).second) {
+      Stylesheet imported;
+      ifstream in(filename.c_str());
+      CssTokenizer tokenizer(in, filename.c_str());
+      CssParser parser(tokenizer);
+
+      parser.parseStylesheet(imported);
+      in.close();
+      if (!canBundleImports(imported, files))
+        return false;
+    }
+  }
+  return true;
+}
+
+std::string LessParser::getRebasePath(const std::string &filename) {
+  std::string path, root = sources.front();
+  size_t pos;
+
+  pos = filename.find_last_of("/\\");
+  if (pos != std::string::npos)
+    path = filename.substr(0, pos + 1);
+
+  pos = root.find_last_of("/\\");
+  root = (pos != std::string::npos) ? root.substr(0, pos + 1) : "";
+  
+  if (path.compare(0, root.size(), root) == 0)
+    path.erase(0, root.size());
+  return path;
+}
+
+void LessParser::rebaseUrls(TokenList &tokens, const std::string &path) {
+  TokenList::iterator i;
+  std::string url;
+  
+  for (i = tokens.begin(); i != tokens.end(); i++) {
+    if ((*i).type != Token::URL)
+      continue;
+
+    url = (*i).getUrlString();
+    // absolute urls, data uris and fragments
+    if (url.empty() || url[0] == '/' || url[0] == '#' ||
+        url.find(':') != std::string::npos)
+      continue;
+
+    if (url.find('"') == std::string::npos)
+      (*i).assign("url(\"" + path + url + "\")");
+    else
+      (*i).assign("url('" + path + url + "')");
+  }
+}
+
+void LessParser::rebaseUrls(Stylesheet &stylesheet,
+                            std::list<Ruleset*>::iterator r_it,
+                            std::list<AtRule*>::iterator a_it,
+                            std::list<MediaQuery*>::iterator m_it,
+                            const std::string &path) {
+  std::list<Declaration*>::iterator d_it;
+
+  if (path.empty())
+    return;
+  
+  for (; r_it != stylesheet.getRulesets().end(); r_it++) {
+    for (d_it = (*r_it)->getDeclarations().begin();
+         d_it != (*r_it)->getDeclarations().end(); d_it++) {
+      rebaseUrls((*d_it)->getValue(), path);
+    }
+  }
+  for (; a_it != stylesheet.getAtRules().end(); a_it++) {
+    rebaseUrls((*a_it)->getRule(), path);
+  }
+  for (; m_it != stylesheet.getMediaQueries().end(); m_it++) {
+    rebaseUrls(**m_it, (*m_it)->getRulesets().begin(),
+               (*m_it)->getAtRules().begin(),
+               (*m_it)->getMediaQueries().begin(), path);
+  }
+}
+
 bool LessParser::findFile(Token& uri, std::string& filename) {
   ifstream* in;
   size_t pos;
@@ -32,13 +32,16 @@
 
 #include "../Token.h"
 #include "../TokenList.h"
+#include "../SourceList.h"
 
 #include "LessTokenizer.h"
+#include "ImportCache.h"
 
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <list>
+#include <set>
   
 /**
  * Extends the css spec with these parts:
@@ -75,19 +78,36 @@ public:
     IMPORT_OPTIONAL = 64;
 
   std::list<const char*>* includePaths;
+  /**
+   * Import .css files into the stylesheet instead of leaving the
+   * @import in the output.
+   */
+  bool bundleCss;
+  /**
+   * Parse each imported .less file once and share the statements
+   * between the stylesheets that import it. NULL to parse every
+   * import into the stylesheet.
+   */
+  ImportCache* importCache;
   
   LessParser(CssTokenizer &tokenizer,
-             std::list<const char*> &source_files):
+             SourceList &source_files):
     CssParser(tokenizer),
+    bundleCss(false),
+    importCache(NULL),
     sources(source_files),
-    reference(false) {
+    reference(false),
+    cachedImport(NULL) {
   }
   LessParser(CssTokenizer &tokenizer,
-             std::list<const char*> &source_files,
+             SourceList &source_files,
              bool isreference):
     CssParser(tokenizer),
+    bundleCss(false),
+    importCache(NULL),
     sources(source_files),
-    reference(isreference) {
+    reference(isreference),
+    cachedImport(NULL) {
   }
   virtual ~LessParser () {
   }
@@ -95,8 +115,13 @@ public:
   virtual void parseStylesheet(LessStylesheet &stylesheet);
   
 protected:
-  std::list<const char*> &sources;
+  SourceList &sources;
   bool reference;
+  /**
+   * The file that is being parsed for the import cache. Its imports
+   * are recorded instead of done.
+   */
+  CachedImport* cachedImport;
 
   /**
    * Skip comments only if they are LESS comments, not CSS comments.
@@ -146,7 +171,36 @@ protected:
 
   bool parseImportStatement(TokenList &statement, LessStylesheet &stylesheet);
   unsigned int parseImportDirective(Token &t);
-  bool importFile(Token uri, LessStylesheet &stylesheet, unsigned int directive);
+  bool importFile(Token uri, const TokenList &media,
+                  LessStylesheet &stylesheet, unsigned int directive);
+  /**
+   * Parse a css file with the plain CssParser and rebase its urls.
+   * The rules are wrapped in an @media block if the import has a
+   * media list. The imports of the file are bundled as well; if one of
+   * them, or one of their imports, is remote or missing nothing is
+   * added and false is returned, so the import can be written as it
+   * is.
+   */
+  bool importCss(const std::string &filename, const TokenList &media,
+                 LessStylesheet &stylesheet, bool isreference);
+  /**
+   * Returns true if the uri at the start of an @import rule refers to
+   * a local file.
+   */
+  bool isLocalImport(const TokenList &rule) const;
+  /**
+   * Returns true if the @imports of a css file, and those of the css
+   * files they import, are all local files that exist. files holds the
+   * css files that have been checked.
+   */
+  bool canBundleImports(Stylesheet &css, std::set<std::string> &files);
+  /**
+   * Parse a file for the import cache. Returns NULL if the file can't
+   * be shared, which is when it has imports inside @media blocks.
+   */
+  CachedImport* parseCachedImport(const std::string &filename,
+                                  bool isreference);
+  void importCachedFile(CachedImport &import, LessStylesheet &stylesheet);
 
   void parseLessMediaQuery(Token &mediatoken,
                            LessStylesheet &stylesheet);
@@ -157,6 +211,18 @@ private:
   std::list<TokenList*>* processArguments(TokenList* arguments);
 
   bool findFile(Token& uri, std::string& filename);
+  
+  /**
+   * The directory of filename relative to the directory of the main
+   * source file.
+   */
+  std::string getRebasePath(const std::string &filename);
+  void rebaseUrls(TokenList &tokens, const std::string &path);
+  void rebaseUrls(Stylesheet &stylesheet,
+                  std::list<Ruleset*>::iterator r_it,
+                  std::list<AtRule*>::iterator a_it,
+                  std::list<MediaQuery*>::iterator m_it,
+                  const std::string &path);
 };
 
 #endif
@@ -23,16 +23,27 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <list>
+#include <map>
 #include <getopt.h>
 #include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "less/LessTokenizer.h"
 #include "less/LessParser.h"
 #include "css/CssWriter.h"
 #include "css/CssPrettyWriter.h"
+#include "css/OutputSink.h"
+#include "css/CompressedOutputSink.h"
+#include "css/IndexMapWriter.h"
 #include "stylesheet/Stylesheet.h"
+#include "stylesheet/StylesheetOptimizer.h"
 #include "css/IOException.h"
 #include "lessstylesheet/LessStylesheet.h"
+#include "value/ImageCache.h"
+#include "value/DataUri.h"
+#include "value/SpriteAtlas.h"
 
 #include <config.h>
 
@@ -50,6 +61,7 @@ using namespace std;
 void usage () {
   cout <<
     "Usage: lessc [OPTION]... [FILE]\n"
+    "       lessc --batch[=MANIFEST] [OPTION]... [INPUT:OUTPUT]...\n"
     "\n"
     "   FILE				Less source file. If not given, source \
 is read from stdin.\n"
@@ -59,6 +71,29 @@ is read from stdin.\n"
     "   -o, --output=<FILE>		Send output to FILE\n"
     "   -f, --format			Format output CSS with newlines and \
 indentation. By default the output is unformatted.\n"
+    "       --stream			Write the output while the \
+stylesheet is processed instead of after it is done.\n"
+    "       --optimize		Merge rulesets, remove overridden \
+declarations, use shorthands and shorten values to make the output \
+smaller. Implies that --stream is ignored.\n"
+    "       --merge-media		Move the rules of @media blocks into \
+the last @media block with the same query where that is safe. Implies \
+that --stream is ignored.\n"
+    "       --bundle-css		Import .css files into the output \
+instead of leaving the @import. Relative urls in them are rebased.\n"
+    "       --batch=[MANIFEST]	Compile each INPUT:OUTPUT pair, given \
+as arguments or one per line in MANIFEST, in one process. Imported \
+files are parsed once. Stylesheets with the same OUTPUT are \
+concatenated.\n"
+    "       --image-cache=<FILE>	Read the sizes and background colors \
+of images from FILE and save them to it, so unchanged images are not \
+read again.\n"
+    "       --data-uri-max-size=<KB>	Files of KB kilobytes or more are \
+not inlined by data-uri(). 0 removes the limit. The default is 32.\n"
+    "\n"
+    "       --precompress=[LEVEL]	Also write FILE.gz, and FILE.br \
+when compiled with brotli, next to the output FILE. LEVEL is a number \
+in the range 1-9, 9 by default.\n"
     "\n"
     "   -m, --source-map=[FILE]	Generate a source map.\n"
     "       --source-map-rootpath=<PATH>   PATH is prepended to the \
@@ -67,6 +102,8 @@ reference in the css output. \n"
     "       --source-map-basepath=<PATH>   PATH is removed from the \
 source file references in the source map, and also from the source \
 map reference in the css output.\n"
+    "       --source-map-inline-sources   Include the text of the \
+source files in the source map.\n"
     "\n"
     "   -v, --verbose=<LEVEL>	Output log data for debugging. LEVEL is \
 a number in the range 1-3 that defines granularity.\n" 
@@ -120,16 +157,36 @@ void parsePathList(const char* path, std::list<const char*>& paths) {
 }
 
 
+/**
+ * The options that apply to every stylesheet that is compiled.
+ */
+struct CompileOptions {
+  bool formatoutput;
+  bool stream;
+  bool optimize;
+  bool mergemedia;
+  bool bundlecss;
+  bool inlinesources;
+  const char* rootpath;
+  const char* sourcemap_rootpath;
+  const char* sourcemap_basepath;
+  std::list<const char*> includePaths;
+  ImportCache* importCache;
+};
+
 bool parseInput(LessStylesheet &stylesheet,
                 istream &in,
                 const char* source,
-                std::list<const char*> &sources,
-                std::list<const char*> &includePaths){
-  std::list<const char*>::iterator i;
+                SourceList &sources,
+                CompileOptions &options){
+  SourceList::const_iterator i;
   
   LessTokenizer tokenizer(in, source);
+  tokenizer.captureInput(sources.getContent(source));
   LessParser parser(tokenizer, sources);
-  parser.includePaths = &includePaths;
+  parser.includePaths = &options.includePaths;
+  parser.bundleCss = options.bundlecss;
+  parser.importCache = options.importCache;
   
   try{
     parser.parseStylesheet(stylesheet);
@@ -159,12 +216,101 @@ bool parseInput(LessStylesheet &stylesheet,
 #endif
   return true;
 }
+/**
+ * Open a file and add a sink that writes to it.
+ */
+OutputSink* openOutput(const std::string &filename,
+                       std::list<OutputSink*> &sinks,
+                       std::list<int> &fds) {
+  int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+  if (fd < 0)
+    throw new IOException("Error opening output file");
+  fds.push_back(fd);
+  sinks.push_back(new FdOutputSink(fd));
+  return sinks.back();
+}
+
+/**
+ * Add compressed copies of the output. The last sink in the list
+ * writes to all of them.
+ */
+void precompressOutput(const std::string &filename, int level,
+                       std::list<OutputSink*> &sinks,
+                       std::list<int> &fds) {
+  OutputSink* out = sinks.back();
+  OutputSink* compressed;
+
+#ifdef WITH_ZLIB
+  compressed = new GzipOutputSink(*openOutput(filename + ".gz", sinks, fds),
+                                  level);
+  sinks.push_back(compressed);
+  out = new TeeOutputSink(*out, *compressed);
+  sinks.push_back(out);
+#endif
+  
+#ifdef WITH_BROTLI
+  // brotli has quality 0-11
+  compressed = new BrotliOutputSink(*openOutput(filename + ".br", sinks,
+                                                fds),
+                                    level == 9 ? 11 : level);
+  sinks.push_back(compressed);
+  out = new TeeOutputSink(*out, *compressed);
+  sinks.push_back(out);
+#endif
+}
+
+/**
+ * Flush the output, delete the sinks and close the files.
+ */
+void closeOutput(std::list<OutputSink*> &sinks, std::list<int> &fds) {
+  sinks.back()->close();
+  sinks.back()->flush();
+  while (!sinks.empty()) {
+    delete sinks.back();
+    sinks.pop_back();
+  }
+  while (!fds.empty()) {
+    close(fds.back());
+    fds.pop_back();
+  }
+}
+
+#ifdef WITH_LIBGLOG
+/**
+ * Returns the size of the stylesheet when written.
+ */
+size_t countOutput (Stylesheet &css, bool formatoutput,
+                    ValueMinifier* minifier) {
+  CountingOutputSink counter;
+  CssWriter* writer = formatoutput ? new CssPrettyWriter(counter) :
+    new CssWriter(counter);
+
+  writer->minifier = minifier;
+  css.write(*writer);
+  writer->flush();
+  delete writer;
+  return counter.getCount();
+}
+#endif
+
 void writeOutput (LessStylesheet &stylesheet,
-                  CssWriter &writer) {
+                  CssWriter &writer,
+                  bool trackLocations,
+                  bool stream,
+                  bool optimize,
+                  bool mergemedia,
+                  bool formatoutput) {
   Stylesheet css;
   ProcessingContext context;
 
+  context.setTrackLocations(trackLocations);
+
   try{
+    if (stream && !optimize && !mergemedia) {
+      stylesheet.process(css, context, writer);
+      return;
+    }
     stylesheet.process(css, context);
 
   } catch(ParseException* e) {
@@ -197,27 +343,298 @@ void writeOutput (LessStylesheet &stylesheet,
     return;
   }
 
+  if (mergemedia)
+    StylesheetOptimizer().mergeMediaQueries(css);
+  
+  if (optimize) {
+#ifdef WITH_LIBGLOG
+    long before = VLOG_IS_ON(1) ? countOutput(css, formatoutput, NULL) : 0;
+#else
+    // the savings are only logged with glog
+    (void)formatoutput;
+#endif
+    
+    StylesheetOptimizer().optimize(css);
+    
+#ifdef WITH_LIBGLOG
+    VLOG(1) << "Optimizing saved " <<
+      (before - (long)countOutput(css, formatoutput, writer.minifier)) <<
+      " bytes";
+#endif
+  }
+  
   css.write(writer);
 }
 
+/**
+ * The reference to a source map that is written in the output: the
+ * basepath is removed and the rootpath is prepended.
+ */
+std::string getSourceMapUrl(std::string sourcemap_file,
+                            const CompileOptions &options) {
+  if (options.sourcemap_basepath != NULL &&
+      sourcemap_file.compare(0, std::strlen(options.sourcemap_basepath),
+                             options.sourcemap_basepath) == 0) {
+    sourcemap_file.erase(0, std::strlen(options.sourcemap_basepath));
+  }
+  if (options.sourcemap_rootpath != NULL)
+    sourcemap_file.insert(0, options.sourcemap_rootpath);
+  return sourcemap_file;
+}
+
+/**
+ * Compile a stylesheet and write it to out. If sourcemap is not NULL
+ * the source map is stored in it, and sourcemap_url is referenced in
+ * the output if it is not NULL. lines is set to the number of lines
+ * that were written.
+ *
+ * @return false if the stylesheet could not be parsed.
+ */
+bool compile(const char* source,
+             istream &in,
+             OutputSink &out,
+             const std::string &output,
+             std::string* sourcemap,
+             const char* sourcemap_url,
+             unsigned int &lines,
+             CompileOptions &options) {
+  LessStylesheet stylesheet;
+  SourceList sources;
+  std::ostringstream sourcemap_s;
+  SourceMapWriter* sourcemapwriter = NULL;
+  CssWriter* writer;
+
+  lines = 0;
+  sources.setKeepContents(options.inlinesources && sourcemap != NULL);
+  sources.addSource(source);
+  
+  if (!parseInput(stylesheet, in, source, sources, options)) {
+    if (options.importCache != NULL)
+      options.importCache->clearBorrowers();
+    return false;
+  }
+  
+  if (sourcemap != NULL) {
+    sourcemapwriter = new SourceMapWriter(sourcemap_s, sources,
+                                          output.c_str(),
+                                          options.sourcemap_rootpath,
+                                          options.sourcemap_basepath);
+
+    writer = options.formatoutput ?
+      new CssPrettyWriter(out, *sourcemapwriter) :
+      new CssWriter(out, *sourcemapwriter);
+  } else {
+    writer = options.formatoutput ? new CssPrettyWriter(out) :
+      new CssWriter(out);
+  }
+  writer->rootpath = options.rootpath;
+  if (options.optimize)
+    writer->minifier = new ValueMinifier();
+      
+  writeOutput(stylesheet, *writer, sourcemapwriter != NULL,
+              options.stream, options.optimize, options.mergemedia,
+              options.formatoutput);
+
+  // the cached imports no longer refer to the stylesheet
+  if (options.importCache != NULL)
+    options.importCache->clearBorrowers();
+
+  lines = 1;
+  if (sourcemapwriter != NULL) {
+    lines += sourcemapwriter->getLines();
+    if (sourcemap_url != NULL) {
+      writer->writeSourceMapUrl(sourcemap_url);
+      lines += 2;
+    }
+    sourcemapwriter->close();
+    delete sourcemapwriter;
+    sourcemap->assign(sourcemap_s.str());
+  }
+  writer->flush();
+      
+  if (writer->minifier != NULL)
+    delete writer->minifier;
+  delete writer;
+  out.write("\n", 1);
+  return true;
+}
+
+/**
+ * An output file in batch mode. Stylesheets that are compiled to the
+ * same file are concatenated, and their source maps are combined in an
+ * index map.
+ */
+struct BatchOutput {
+  std::list<OutputSink*> sinks;
+  std::list<int> fds;
+  /**
+   * The number of stylesheets that still have to be written.
+   */
+  unsigned int stylesheets;
+  unsigned int line;
+  std::ofstream* sourcemap_s;
+  IndexMapWriter* indexmap;
+
+  BatchOutput(): stylesheets(0), line(0), sourcemap_s(NULL),
+                 indexmap(NULL) {
+  }
+};
+
+/**
+ * Read the INPUT:OUTPUT pairs of a batch manifest, one per
+ * line. Empty lines and lines starting with '#' are skipped.
+ */
+void readManifest(istream &in, std::list<std::string> &pairs) {
+  std::string line;
+  size_t end;
+
+  while (std::getline(in, line)) {
+    end = line.find_last_not_of(" \t\r");
+    if (end == std::string::npos || line[0] == '#')
+      continue;
+    pairs.push_back(line.substr(0, end + 1));
+  }
+}
+
+/**
+ * Compile each INPUT:OUTPUT pair. Imported files are parsed once and
+ * shared by the stylesheets that import them.
+ *
+ * @return false if one of the stylesheets could not be compiled.
+ */
+bool compileBatch(const std::list<std::string> &pairs,
+                  bool sourcemaps,
+                  int precompress,
+                  CompileOptions &options) {
+  std::list<std::pair<std::string, std::string> > entries;
+  std::list<std::pair<std::string, std::string> >::iterator e_it;
+  std::list<std::string>::const_iterator p_it;
+  std::map<std::string, BatchOutput> outputs;
+  ImportCache importCache;
+  std::string sourcemap;
+  std::string sourcemap_url;
+  unsigned int lines;
+  size_t pos;
+  bool success = true;
+
+  options.importCache = &importCache;
+
+  for (p_it = pairs.begin(); p_it != pairs.end(); p_it++) {
+    pos = (*p_it).rfind(':');
+    if (pos == std::string::npos || pos == 0 ||
+        pos == (*p_it).size() - 1) {
+      throw new IOException("Batch entries have to be in the form \
+INPUT:OUTPUT.");
+    }
+    entries.push_back(std::pair<std::string, std::string>
+                      ((*p_it).substr(0, pos), (*p_it).substr(pos + 1)));
+    if ((sourcemaps || precompress > 0) &&
+        entries.back().second == "-") {
+      throw new IOException("Source maps and --precompress in batch \
+mode require an output file for each stylesheet.");
+    }
+    outputs[entries.back().second].stylesheets++;
+  }
+
+  for (e_it = entries.begin(); e_it != entries.end(); e_it++) {
+    const char* source = (*e_it).first.c_str();
+    const std::string &output = (*e_it).second;
+    BatchOutput &o = outputs[output];
+    ifstream in(source);
+
+#ifdef WITH_LIBGLOG
+    VLOG(1) << source << " -> " << output;
+#endif
+    
+    if (o.sinks.empty()) {
+      if (output == "-")
+        o.sinks.push_back(new StreamOutputSink(cout));
+      else {
+        openOutput(output, o.sinks, o.fds);
+        if (precompress > 0)
+          precompressOutput(output, precompress, o.sinks, o.fds);
+      }
+      if (sourcemaps) {
+        o.sourcemap_s = new ofstream((output + ".map").c_str());
+        if (o.stylesheets > 1) {
+          o.indexmap = new IndexMapWriter(*o.sourcemap_s,
+                                          output.c_str());
+        }
+      }
+    }
+    sourcemap_url = getSourceMapUrl(output + ".map", options);
+    
+    if (in.fail()) {
+#ifdef WITH_LIBGLOG
+      LOG(ERROR) << source << ": Error opening file";
+#else
+      cerr << source << ": Error opening file" << endl;
+#endif
+      success = false;
+      
+    } else if (compile(source, in, *o.sinks.back(), output,
+                       sourcemaps ? &sourcemap : NULL,
+                       o.indexmap == NULL ? sourcemap_url.c_str() : NULL,
+                       lines, options)) {
+      if (o.indexmap != NULL)
+        o.indexmap->writeSection(o.line, 0, sourcemap);
+      else if (sourcemaps)
+        *o.sourcemap_s << sourcemap;
+      o.line += lines;
+    } else
+      success = false;
+
+    if (--o.stylesheets > 0)
+      continue;
+
+    if (o.indexmap != NULL) {
+      CssWriter writer(*o.sinks.back());
+      writer.writeSourceMapUrl(sourcemap_url.c_str());
+      writer.flush();
+      o.indexmap->close();
+      delete o.indexmap;
+    }
+    if (o.sourcemap_s != NULL)
+      delete o.sourcemap_s;
+    closeOutput(o.sinks, o.fds);
+  }
+  SpriteAtlas::writeAtlases();
+  return success;
+}
+
 int main(int argc, char * argv[]){
   istream* in = &cin;
-  ostream* out = &cout;
-  bool formatoutput = false;
+  std::list<int> out_fds;
+  std::list<OutputSink*> sinks;
+  OutputSink* out;
+  int precompress = 0;
+  const char* imagecache = NULL;
+  long datauri_max;
+  char* end;
   char* source = NULL;
   string output = "-";
-  LessStylesheet stylesheet;
-  std::list<const char*> sources;
-  CssWriter* writer;
+  CompileOptions options;
+  unsigned int lines;
+
+  bool batch = false;
+  std::list<std::string> batch_pairs;
+  const char* batch_manifest = NULL;
 
   std::string sourcemap_file = "";
-  ostream* sourcemap_s = NULL;
-  SourceMapWriter* sourcemap = NULL;
-  const char* sourcemap_rootpath = NULL;
-  const char* sourcemap_basepath = NULL;
-  const char* rootpath = NULL;
+  std::string sourcemap;
+  std::string sourcemap_url;
+  ofstream* sourcemap_s = NULL;
 
-  std::list<const char*> includePaths;
+  options.formatoutput = false;
+  options.stream = false;
+  options.optimize = false;
+  options.mergemedia = false;
+  options.bundlecss = false;
+  options.inlinesources = false;
+  options.rootpath = NULL;
+  options.sourcemap_rootpath = NULL;
+  options.sourcemap_basepath = NULL;
+  options.importCache = NULL;
 
   static struct option long_options[] = {
     {"version",    no_argument,       0, 1},
@@ -228,8 +645,17 @@ int main(int argc, char * argv[]){
     {"source-map", optional_argument, 0, 'm'},
     {"source-map-rootpath", required_argument, 0, 2},
     {"source-map-basepath", required_argument, 0, 3},
+    {"source-map-inline-sources", no_argument, 0, 10},
+    {"image-cache", required_argument, 0, 11},
     {"include-path", required_argument,        0, 'I'},
     {"rootpath", required_argument,  0, 4},
+    {"stream",   no_argument,        0, 5},
+    {"optimize", no_argument,        0, 6},
+    {"merge-media", no_argument,     0, 7},
+    {"bundle-css", no_argument,      0, 8},
+    {"precompress", optional_argument, 0, 9},
+    {"batch",    optional_argument,  0, 12},
+    {"data-uri-max-size", required_argument, 0, 13},
     {0,0,0,0}
   };
   
@@ -255,10 +681,9 @@ int main(int argc, char * argv[]){
         return 0;
       case 'o':
         output = optarg;
-        out = new ofstream(optarg);
         break;
       case 'f':
-        formatoutput = true;
+        options.formatoutput = true;
         break;
       case 'v':
 #ifdef WITH_LIBGLOG
@@ -275,22 +700,107 @@ int main(int argc, char * argv[]){
         break;
         
       case 2:
-        sourcemap_rootpath = createPath(optarg, std::strlen(optarg));
+        options.sourcemap_rootpath = createPath(optarg, std::strlen(optarg));
         break;
       case 3:
-        sourcemap_basepath = createPath(optarg, std::strlen(optarg));
+        options.sourcemap_basepath = createPath(optarg, std::strlen(optarg));
         break;
 
       case 'I':
-        parsePathList(optarg, includePaths);
+        parsePathList(optarg, options.includePaths);
         break;
 
       case 4:
-        rootpath = createPath(optarg, std::strlen(optarg));
+        options.rootpath = createPath(optarg, std::strlen(optarg));
         break;
 
+      case 5:
+        options.stream = true;
+        break;
+
+      case 6:
+        options.optimize = true;
+        break;
+
+      case 7:
+        options.mergemedia = true;
+        break;
+
+      case 8:
+        options.bundlecss = true;
+        break;
+
+      case 9:
+#ifndef WITH_ZLIB
+        throw new IOException("--precompress is not supported: lessc \
+has to be compiled with zlib.");
+#endif
+        precompress = optarg ? atoi(optarg) : 9;
+        if (precompress < 1 || precompress > 9)
+          throw new IOException("The compression level has to be in \
+the range 1-9.");
+        break;
+
+      case 10:
+        options.inlinesources = true;
+        break;
+
+      case 11:
+        imagecache = optarg;
+        break;
+
+      case 12:
+        batch = true;
+        batch_manifest = optarg;
+        break;
+
+      case 13:
+        datauri_max = strtol(optarg, &end, 10);
+        if (*optarg == '\0' || *end != '\0' || datauri_max < 0)
+          throw new IOException("The data uri size limit has to be a \
+number of kilobytes.");
+        DataUri::getInstance().setMaxSize((size_t)datauri_max * 1024);
+        break;
       }
     }
+
+    if (batch) {
+      if (output != "-")
+        throw new IOException("-o can not be used with --batch.");
+      if (sourcemap_file != "" && sourcemap_file != "-") {
+        throw new IOException("--batch writes the source map of each \
+output to OUTPUT.map; -m does not take a file name in batch mode.");
+      }
+      
+      for (; optind < argc; optind++) 
+        batch_pairs.push_back(argv[optind]);
+      
+      if (batch_manifest != NULL) {
+        if (std::strcmp(batch_manifest, "-") == 0)
+          readManifest(cin, batch_pairs);
+        else {
+          ifstream manifest(batch_manifest);
+          if (manifest.fail())
+            throw new IOException("Error opening batch manifest");
+          readManifest(manifest, batch_pairs);
+        }
+      }
+      if (batch_pairs.empty()) {
+        throw new IOException("--batch requires INPUT:OUTPUT pairs or \
+a manifest file.");
+      }
+      
+      if (imagecache != NULL)
+        ImageCache::getInstance().load(imagecache);
+      
+      if (!compileBatch(batch_pairs, sourcemap_file != "", precompress,
+                        options))
+        return 1;
+      
+      if (imagecache != NULL)
+        ImageCache::getInstance().save(imagecache);
+      return 0;
+    }
     
     if(argc - optind >= 1){
 #ifdef WITH_LIBGLOG
@@ -318,46 +828,38 @@ source.");
       sourcemap_file += ".map";
     }
 
-    sources.push_back(source);
+    if (imagecache != NULL)
+      ImageCache::getInstance().load(imagecache);
     
-    if (parseInput(stylesheet, *in, source, sources, includePaths)) {
+    if (output != "-") {
+      openOutput(output, sinks, out_fds);
+      if (precompress > 0)
+        precompressOutput(output, precompress, sinks, out_fds);
+    } else if (precompress > 0) {
+      throw new IOException("--precompress requires an output file.");
+    } else
+      sinks.push_back(new StreamOutputSink(cout));
+    out = sinks.back();
+
+    sourcemap_url = getSourceMapUrl(sourcemap_file, options);
+    
+    if (compile(source, *in, *out, output,
+                sourcemap_file != "" ? &sourcemap : NULL,
+                sourcemap_url.c_str(), lines, options)) {
+      SpriteAtlas::writeAtlases();
+      
       if (sourcemap_file != "") {
 #ifdef WITH_LIBGLOG
         VLOG(1) << "sourcemap: " << sourcemap_file;
 #endif
         sourcemap_s = new ofstream(sourcemap_file.c_str());
-        sourcemap = new SourceMapWriter(*sourcemap_s, sources, output.c_str(),
-                                        sourcemap_rootpath,
-                                        sourcemap_basepath);
-
-        writer = formatoutput ? new CssPrettyWriter(*out, *sourcemap) :
-          new CssWriter(*out, *sourcemap);
-      } else {
-        writer = formatoutput ? new CssPrettyWriter(*out) :
-          new CssWriter(*out);
-      }
-      writer->rootpath = rootpath;
-      
-      writeOutput(stylesheet, *writer);
-      
-      if (sourcemap != NULL) {
-        if (sourcemap_basepath != NULL &&
-            sourcemap_file.compare(0, std::strlen(sourcemap_basepath),
-                                   sourcemap_basepath) == 0) {
-          sourcemap_file.erase(0, std::strlen(sourcemap_basepath));
-        }
-        if (sourcemap_rootpath != NULL)
-          sourcemap_file.insert(0, sourcemap_rootpath);
-        
-        writer->writeSourceMapUrl(sourcemap_file.c_str());
-        sourcemap->close();
-        delete sourcemap;
-        if (sourcemap_s != NULL)
-          delete sourcemap_s;
+        *sourcemap_s << sourcemap;
+        delete sourcemap_s;
       }
       
-      delete writer;
-      *out << endl;
+      closeOutput(sinks, out_fds);
+      if (imagecache != NULL)
+        ImageCache::getInstance().save(imagecache);
     } else
       return 1;
     delete source;
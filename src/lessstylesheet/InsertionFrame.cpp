@@ -0,0 +1,147 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "InsertionFrame.h"
+#include "LessRuleset.h"
+#include "Mixin.h"
+#include "UnprocessedStatement.h"
+#include "ProcessingContext.h"
+
+#include <config.h>
+
+#ifdef WITH_LIBGLOG
+#include <glog/logging.h>
+#endif
+
+InsertionFrame::InsertionFrame(LessRuleset &ruleset, Mixin* mixin,
+                               Ruleset &target) {
+  this->ruleset = &ruleset;
+  this->mixin = mixin;
+  this->target = &target;
+  stylesheet = target.getStylesheet();
+  state = START;
+}
+
+InsertionFrame::InsertionFrame(LessRuleset &ruleset, Mixin* mixin,
+                               Stylesheet &s) {
+  this->ruleset = &ruleset;
+  this->mixin = mixin;
+  target = NULL;
+  stylesheet = &s;
+  state = START;
+}
+
+InsertionFrame::~InsertionFrame() {
+}
+
+bool InsertionFrame::next(ProcessingContext &context) {
+  switch (state) {
+  case START:
+    return start(context);
+
+  case STATEMENTS:
+    if (insertStatement())
+      return true;
+
+#ifdef WITH_LIBGLOG
+    VLOG(2) << "Inserting nested rules";
+#endif
+    
+    state = NESTED_RULES;
+    nested = ruleset->getNestedRules().begin();
+    // fall through
+
+  case NESTED_RULES:
+    if (insertNestedRule(context))
+      return true;
+  }
+  
+  end(context);
+  return false;
+}
+
+bool InsertionFrame::start(ProcessingContext &context) {
+  LessSelector* selector = ruleset->getLessSelector();
+  
+  context.pushRuleset(*ruleset);
+  context.pushScope(scope);
+
+  if (!((mixin == NULL && !selector->needsArguments()) ||
+        (mixin != NULL && ruleset->putArguments(*mixin, scope))) ||
+      !ruleset->matchConditions(context)) {
+    context.popScope();
+    context.popRuleset();
+    return false;
+  }
+
+#ifdef WITH_LIBGLOG
+  VLOG(2) << "Inserting variables";
+#endif
+    
+  // set local variables
+  context.pushScope(ruleset->getVariables());
+  ruleset->setContext(context);
+
+#ifdef WITH_LIBGLOG
+  VLOG(2) << "Inserting statements";
+#endif
+  
+  state = STATEMENTS;
+  if (target != NULL)
+    statement = ruleset->getStatements().begin();
+  else
+    unprocessed = ruleset->getUnprocessedStatements().begin();
+  return true;
+}
+
+bool InsertionFrame::insertStatement() {
+  if (target != NULL) {
+    if (statement == ruleset->getStatements().end())
+      return false;
+    (*statement)->process(*target);
+    statement++;
+    
+  } else {
+    // only mixins and @-rules can be inserted in a stylesheet
+    if (unprocessed == ruleset->getUnprocessedStatements().end())
+      return false;
+    (*unprocessed)->insert(*stylesheet);
+    unprocessed++;
+  }
+  return true;
+}
+
+bool InsertionFrame::insertNestedRule(ProcessingContext &context) {
+  if (nested == ruleset->getNestedRules().end())
+    return false;
+
+  (*nested)->process(*stylesheet,
+                     (target != NULL) ? &target->getSelector() : NULL,
+                     context);
+  nested++;
+  return true;
+}
+
+void InsertionFrame::end(ProcessingContext &context) {
+  context.popScope();
+  context.popScope();
+  context.popRuleset();
+}
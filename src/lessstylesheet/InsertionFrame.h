@@ -0,0 +1,73 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __InsertionFrame_h__
+#define __InsertionFrame_h__
+
+#include "ProcessingFrame.h"
+#include "../SharedTokenList.h"
+#include "../stylesheet/Stylesheet.h"
+#include "../stylesheet/Ruleset.h"
+#include "../stylesheet/RulesetStatement.h"
+
+#include <list>
+#include <map>
+#include <string>
+
+class LessRuleset;
+class Mixin;
+class UnprocessedStatement;
+
+/**
+ * Inserts the statements and nested rules of a LessRuleset in a
+ * ruleset or, for mixins called outside of a ruleset, in a stylesheet.
+ * One statement or nested rule is processed in each call to next().
+ */
+class InsertionFrame: public ProcessingFrame {
+private:
+  enum State {START, STATEMENTS, NESTED_RULES};
+  
+  LessRuleset* ruleset;
+  Mixin* mixin;
+  Ruleset* target;
+  Stylesheet* stylesheet;
+  
+  std::map<std::string, SharedTokenList> scope;
+  State state;
+  
+  std::list<RulesetStatement*>::iterator statement;
+  std::list<UnprocessedStatement*>::iterator unprocessed;
+  std::list<LessRuleset*>::iterator nested;
+
+  bool start(ProcessingContext &context);
+  bool insertStatement();
+  bool insertNestedRule(ProcessingContext &context);
+  void end(ProcessingContext &context);
+  
+public:
+  InsertionFrame(LessRuleset &ruleset, Mixin* mixin, Ruleset &target);
+  InsertionFrame(LessRuleset &ruleset, Mixin* mixin, Stylesheet &s);
+  virtual ~InsertionFrame();
+
+  virtual bool next(ProcessingContext &context);
+};
+
+#endif
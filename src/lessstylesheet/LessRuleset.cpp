@@ -22,6 +22,7 @@
 #include "LessRuleset.h"
 #include "LessStylesheet.h"
 #include "MediaQueryRuleset.h"
+#include "InsertionFrame.h"
 
 #include <config.h>
 
@@ -29,6 +30,12 @@
 #include <glog/logging.h>
 #endif
 
+static bool isTrimmed(const TokenList &tokens) {
+  return (tokens.empty() ||
+          (tokens.front().type != Token::WHITESPACE &&
+           tokens.back().type != Token::WHITESPACE));
+}
+
 LessRuleset::LessRuleset() : Ruleset() {
   parent = NULL;
   lessStylesheet = NULL;
@@ -115,7 +122,7 @@ void LessRuleset::putVariable(const std::string &key, const TokenList &value) {
   variables[key] = value;  
 }
 
-map<string, TokenList>& LessRuleset::getVariables() {
+map<string, SharedTokenList>& LessRuleset::getVariables() {
   return variables;
 }
  
@@ -137,6 +144,9 @@ LessStylesheet* LessRuleset::getLessStylesheet() {
   return lessStylesheet;
 }
 
+void LessRuleset::setContext(ProcessingContext &context) {
+  this->context = &context;
+}
 ProcessingContext* LessRuleset::getContext() {
   return context;
 }
@@ -151,91 +161,40 @@ void LessRuleset::processExtensions(ProcessingContext& context,
   for (e_it = e.begin(); e_it != e.end(); e_it++) {
     extension = *e_it;
     if (prefix != NULL) 
-      extension.getExtension().addPrefix(*prefix);
+      extension.getExtension().addPrefix(*prefix,
+                                        context.isTrackingLocations());
     context.addExtension(extension);
   }
 }
 
-bool LessRuleset::insert(Mixin *mixin, Ruleset &target,
-                         ProcessingContext &context) {
-  map<string, TokenList> scope;
-  bool ret = false;
-  context.pushRuleset(*this);
-  
-  context.pushScope(scope);
-  
-  if (((mixin == NULL && !selector->needsArguments()) ||
-       (mixin != NULL && putArguments(*mixin, scope))) &&
-      matchConditions(context)) {
-
-#ifdef WITH_LIBGLOG
-    VLOG(2) << "Inserting variables";
-#endif
-    
-    // set local variables
-    context.pushScope(variables);
-
-#ifdef WITH_LIBGLOG
-    VLOG(2) << "Inserting statements";
-#endif
-
-   
-    this->context = &context;
-    // process statements
-    Ruleset::insert(target);
+bool LessRuleset::hasExtensions(bool mixins) {
+  std::list<UnprocessedStatement*>::iterator s_it;
+  std::list<LessRuleset*>::iterator r_it;
 
-#ifdef WITH_LIBGLOG
-    VLOG(2) << "Inserting nested rules";
-#endif
-  
-    // insert nested rules
-    insertNestedRules(*target.getStylesheet(), &target.getSelector(), context);
+  if (!getLessSelector()->getExtensions().empty())
+    return true;
 
-    context.popScope();
-    ret = true;
+  for (s_it = unprocessedStatements.begin();
+       s_it != unprocessedStatements.end(); s_it++) {
+    if ((*s_it)->isExtends() ||
+        (mixins && (*s_it)->isMixinCall()))
+      return true;
   }
-  context.popScope();
-  context.popRuleset();
-  return ret;
+  for (r_it = nestedRules.begin(); r_it != nestedRules.end(); r_it++) {
+    if ((*r_it)->hasExtensions(mixins))
+      return true;
+  }
+  return false;
 }
 
-bool LessRuleset::insert(Mixin *mixin, Stylesheet &s,
+void LessRuleset::insert(Mixin *mixin, Ruleset &target,
                          ProcessingContext &context) {
-  map<string, TokenList> scope;
-  list<UnprocessedStatement*>& unprocessedStatements = getUnprocessedStatements();
-  list<UnprocessedStatement*>::iterator up_it;
-  bool ret = false;
-
-  context.pushRuleset(*this);
-  context.pushScope(scope);
-
-  if (((mixin == NULL && !selector->needsArguments()) ||
-       (mixin != NULL && putArguments(*mixin, scope))) &&
-      matchConditions(context)) {
-
-    // set local variables
-    context.pushScope(variables);
-
-    this->context = &context;
-
-    
-    // insert mixins
-    for (up_it = unprocessedStatements.begin();
-         up_it != unprocessedStatements.end();
-         up_it++) {
-      (*up_it)->insert(s);
-    }
-    
-    // insert nested rules
-    insertNestedRules(s, NULL, context);
-
-    context.popScope();
-    ret = true;
-  }
+  context.pushFrame(new InsertionFrame(*this, mixin, target));
+}
 
-  context.popScope();
-  context.popRuleset();
-  return ret;
+void LessRuleset::insert(Mixin *mixin, Stylesheet &s,
+                         ProcessingContext &context) {
+  context.pushFrame(new InsertionFrame(*this, mixin, s));
 }
 
 void LessRuleset::process(Stylesheet &s) {
@@ -252,7 +211,8 @@ void LessRuleset::process(Stylesheet &s, Selector* prefix,
   target->setSelector(getSelector());
 
   if (prefix != NULL)
-    target->getSelector().addPrefix(*prefix);
+    target->getSelector().addPrefix(*prefix,
+                                    context.isTrackingLocations());
 
 #ifdef WITH_LIBGLOG
   VLOG(2) << "Processing Less Ruleset: " <<
@@ -317,36 +277,22 @@ void LessRuleset::getLocalLessRulesets(std::list<LessRuleset*> &rulesetList,
 }
 
 
-void LessRuleset::insertNestedRules(Stylesheet &s, Selector *prefix,
-                                    ProcessingContext &context) {
-  std::list<LessRuleset*>& nestedRules = getNestedRules();
-  std::list<LessRuleset*>::iterator r_it;
-
-  for (r_it = nestedRules.begin(); r_it != nestedRules.end(); r_it++) {
-    (*r_it)->process(s, prefix, context);
-  }
-}
-
-
 bool LessRuleset::matchConditions(ProcessingContext &context){
   std::list<TokenList>& conditions = selector->getConditions();
   std::list<TokenList>::iterator cit;
-  TokenList condition;
 
   if (conditions.empty())
     return true;
 
   for(cit = conditions.begin(); cit != conditions.end(); cit++) {
-    condition = (*cit);
-    
 #ifdef WITH_LIBGLOG
-    VLOG(3) << "Checking condition: " << condition.toString();
+    VLOG(3) << "Checking condition: " << (*cit).toString();
 #endif
     
-    if (context.validateCondition(condition)) {
+    if (context.validateCondition(*cit)) {
       
 #ifdef WITH_LIBGLOG
-      VLOG(3) << "Found valid condition: " << condition.toString();
+      VLOG(3) << "Found valid condition: " << (*cit).toString();
 #endif
       
       return true;
@@ -356,13 +302,14 @@ bool LessRuleset::matchConditions(ProcessingContext &context){
 }
   
 bool LessRuleset::putArguments(const Mixin &mixin,
-                               std::map<std::string, TokenList> &scope) {
+                               std::map<std::string, SharedTokenList> &scope) {
   std::list<std::string>& parameters = selector->getParameters();
   std::list<std::string>::iterator pit;
   TokenList argsCombined;
   TokenList restVar;
-  const TokenList* variable;
-  size_t pos = 0;
+  const SharedTokenList* variable;
+  const SharedTokenList* first = NULL;
+  size_t pos = 0, count = 0;
 
   // combine with parameter names and add to local scope
   for(pit = parameters.begin(); pit != parameters.end(); pit++) {
@@ -374,13 +321,15 @@ bool LessRuleset::putArguments(const Mixin &mixin,
     if (variable == NULL)
       variable = selector->getDefault(*pit);
 
-    if (variable == NULL || variable->empty()) 
+    if (variable == NULL || (*variable)->empty()) 
       return false;
     
-    scope.insert(pair<std::string, TokenList>(*pit, *variable));
+    scope.insert(pair<std::string, SharedTokenList>(*pit, *variable));
 
+    if (first == NULL)
+      first = variable;
     argsCombined.insert(argsCombined.end(),
-                        variable->begin(), variable->end());
+                        (*variable)->begin(), (*variable)->end());
     argsCombined.push_back(Token::BUILTIN_SPACE);
   }
 
@@ -393,17 +342,34 @@ bool LessRuleset::putArguments(const Mixin &mixin,
   if (selector->unlimitedArguments() &&
       selector->getRestIdentifier() != "") {
 
+    variable = NULL;
     while (pos < mixin.getArgumentCount()) {
       variable = mixin.getArgument(pos++);
       restVar.insert(restVar.end(),
-                     variable->begin(), variable->end());
+                     (*variable)->begin(), (*variable)->end());
       restVar.push_back(Token::BUILTIN_SPACE);
+      count++;
     }
     
     restVar.trim();
-    scope.insert(pair<std::string,TokenList>(selector->getRestIdentifier(), restVar));
+    
+    if (count == 1 && isTrimmed(**variable)) {
+      scope.insert(pair<std::string,
+                   SharedTokenList>(selector->getRestIdentifier(),
+                                    *variable));
+    } else {
+      scope.insert(pair<std::string,
+                   SharedTokenList>(selector->getRestIdentifier(),
+                                    restVar));
+    }
+  }
+
+  // A single argument can be shared instead of copying it.
+  if (parameters.size() == 1 && isTrimmed(**first)) {
+    scope.insert(pair<std::string,SharedTokenList>("@arguments", *first));
+  } else {
+    scope.insert(pair<std::string,SharedTokenList>("@arguments",
+                                                   argsCombined));
   }
-  
-  scope.insert(pair<std::string,TokenList>("@arguments", argsCombined));
   return true;
 }
@@ -31,6 +31,7 @@
 
 #include "../Token.h"
 #include "../TokenList.h"
+#include "../SharedTokenList.h"
 
 #include "UnprocessedStatement.h"
 #include "LessSelector.h"
@@ -47,7 +48,7 @@ class MediaQueryRuleset;
 class LessRuleset: public Ruleset {
   
 protected:
-  map<string, TokenList> variables;  
+  map<string, SharedTokenList> variables;  
   list<LessRuleset*> nestedRules;
   list<UnprocessedStatement*> unprocessedStatements;
 
@@ -58,8 +59,6 @@ protected:
   ProcessingContext* context;
 
   void processVariables();
-  void insertNestedRules(Stylesheet &s, Selector* prefix,
-                         ProcessingContext &context);
   
 public:
   LessRuleset();
@@ -81,7 +80,7 @@ public:
   list<LessRuleset*>& getNestedRules();
 
   void putVariable(const std::string &key, const TokenList &value);
-  map<string, TokenList>& getVariables();
+  map<string, SharedTokenList>& getVariables();
 
   void setParent(LessRuleset* r);
   LessRuleset* getParent();
@@ -89,14 +88,27 @@ public:
   void setLessStylesheet(LessStylesheet &stylesheet);
   LessStylesheet* getLessStylesheet();
 
+  void setContext(ProcessingContext &context);
   ProcessingContext* getContext();
   
   void processExtensions(ProcessingContext &context,
                          Selector* prefix);
+
+  /**
+   * Check if the ruleset or its nested rules contain extensions. If
+   * mixins is true, mixin calls are counted as well because the mixin
+   * may add extensions.
+   */
+  bool hasExtensions(bool mixins);
   
-  virtual bool insert(Mixin* mixin, Ruleset &target,
+  /**
+   * Insert the statements and nested rules in target. The insertion
+   * is pushed on the frame stack of the context so it may be completed
+   * after this method returns.
+   */
+  virtual void insert(Mixin* mixin, Ruleset &target,
                       ProcessingContext& context);
-  virtual bool insert(Mixin* mixin, Stylesheet &s,
+  virtual void insert(Mixin* mixin, Stylesheet &s,
                       ProcessingContext& context);
 
   virtual void process(Stylesheet &s);
@@ -116,7 +128,7 @@ public:
 
   bool matchConditions(ProcessingContext &context);
   bool putArguments(const Mixin &mixin,
-                    std::map<std::string, TokenList> &scope);
+                    std::map<std::string, SharedTokenList> &scope);
 };
 
 #endif
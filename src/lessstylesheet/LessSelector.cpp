@@ -370,9 +370,9 @@ bool LessSelector::parseConditions (TokenList &selector) {
 }
 
 
-TokenList* LessSelector::getDefault(const std::string &keyword) {
+const SharedTokenList* LessSelector::getDefault(const std::string &keyword) {
   std::list<std::string>::iterator pit = parameters.begin();
-  std::list<TokenList>::iterator dit = defaults.begin();
+  std::list<SharedTokenList>::iterator dit = defaults.begin();
 
   for (;pit != parameters.end(); pit++, dit++) {
     if ((*pit) == keyword)
@@ -395,14 +395,14 @@ std::list<Extension>& LessSelector::getExtensions() {
 
 bool LessSelector::matchArguments(const Mixin &mixin) {
   std::list<std::string>::iterator p_it = parameters.begin();
-  std::list<TokenList>::iterator d_it = defaults.begin();
+  std::list<SharedTokenList>::iterator d_it = defaults.begin();
   size_t pos = 0;
 
   for(; p_it != parameters.end(); p_it++, d_it++) {
     
     if (mixin.getArgument(*p_it) == NULL &&
         mixin.getArgument(pos++) == NULL &&
-        (*d_it).empty()) {
+        (*d_it)->empty()) {
           return false;
     }
   }
@@ -24,6 +24,7 @@
 
 
 #include "../stylesheet/Selector.h"
+#include "../SharedTokenList.h"
 #include "Mixin.h"
 #include "Extension.h"
 
@@ -35,7 +36,7 @@ class LessSelector: public Selector {
 private:
   std::list<Extension> extensions;
   std::list<string> parameters;
-  std::list<TokenList> defaults;
+  std::list<SharedTokenList> defaults;
   std::list<TokenList> conditions;
 
   bool _unlimitedArguments;
@@ -57,7 +58,7 @@ public:
   
   std::list<Extension>& getExtensions();
   std::list<std::string>& getParameters();
-  TokenList* getDefault(const std::string &parameter);
+  const SharedTokenList* getDefault(const std::string &parameter);
 
   std::list<TokenList>& getConditions();
   bool matchArguments(const Mixin &arguments);
@@ -11,6 +11,16 @@ LessStylesheet::LessStylesheet() {
 }
 
 LessStylesheet::~LessStylesheet() {
+  std::list<StylesheetStatement*>& statements = getStatements();
+  std::list<StylesheetStatement*>::iterator i = statements.begin();
+
+  // borrowed statements are deleted by the stylesheet they belong to
+  while (!borrowed.empty() && i != statements.end()) {
+    if (borrowed.count(*i) > 0)
+      i = statements.erase(i);
+    else
+      i++;
+  }
 }
 
 LessRuleset* LessStylesheet::createLessRuleset() {
@@ -54,6 +64,7 @@ LessMediaQuery* LessStylesheet::createLessMediaQuery() {
   
   addStatement(*q);
   q->setLessStylesheet(*this);
+  lessmediaqueries.push_back(q);
   return q;
 }
 
@@ -65,6 +76,23 @@ void LessStylesheet::deleteLessRuleset(LessRuleset &ruleset) {
 void LessStylesheet::deleteMixin(Mixin &mixin) {
   deleteStatement(mixin);
 }
+
+void LessStylesheet::borrowStatement(StylesheetStatement &statement) {
+  LessRuleset* ruleset = dynamic_cast<LessRuleset*>(&statement);
+  LessMediaQuery* query = dynamic_cast<LessMediaQuery*>(&statement);
+  AtRule* atrule = dynamic_cast<AtRule*>(&statement);
+
+  getStatements().push_back(&statement);
+  borrowed.insert(&statement);
+  
+  if (ruleset != NULL) {
+    getRulesets().push_back(ruleset);
+    lessrulesets.push_back(ruleset);
+  } else if (query != NULL) 
+    lessmediaqueries.push_back(query);
+  else if (atrule != NULL)
+    getAtRules().push_back(atrule);
+}
   
 void LessStylesheet::getLessRulesets(list<LessRuleset*> &rulesetList,
                                      const Mixin &mixin) {
@@ -84,17 +112,75 @@ ProcessingContext* LessStylesheet::getContext() {
   return context;
 }
 
-void LessStylesheet::putVariable(const std::string &key, const TokenList &value) {
+void LessStylesheet::putVariable(const std::string &key,
+                                 const SharedTokenList &value) {
   variables[key] = value;
 }
 
 
-void LessStylesheet::process(Stylesheet &s, ProcessingContext &context) {
-  std::list<Extension>* extensions;
-  
+bool LessStylesheet::hasExtensions() {
+  std::list<LessRuleset*>::iterator r_it;
+  std::list<LessMediaQuery*>::iterator m_it;
+
+  for (r_it = lessrulesets.begin(); r_it != lessrulesets.end(); r_it++) {
+    if ((*r_it)->hasExtensions(false))
+      return true;
+  }
+  for (m_it = lessmediaqueries.begin(); m_it != lessmediaqueries.end();
+       m_it++) {
+    if ((*m_it)->hasExtensions())
+      return true;
+  }
+  return false;
+}
+
+StylesheetStatement* LessStylesheet::getLastExtendingStatement() {
+  std::list<StylesheetStatement*>& statements = getStatements();
+  std::list<StylesheetStatement*>::iterator s_it;
+  StylesheetStatement* last = NULL;
+  std::list<LessRuleset*>::iterator r_it = lessrulesets.begin();
+  std::list<AtRule*>::iterator a_it = getAtRules().begin();
+
+  if (!hasExtensions())
+    return last;
+
+  // The rulesets and @-rules are in the same order as the statements.
+  for (s_it = statements.begin(); s_it != statements.end(); s_it++) {
+    if (r_it != lessrulesets.end() && *s_it == *r_it) {
+      if (!(*r_it)->getLessSelector()->needsArguments() &&
+          (*r_it)->hasExtensions(true))
+        last = *s_it;
+      r_it++;
+      
+    } else if (a_it != getAtRules().end() && *s_it == *a_it) {
+      a_it++;
+
+    } else {
+      // mixin calls, media queries and comments
+      last = *s_it;
+    }
+  }
+  return last;
+}
+
+void LessStylesheet::applyExtensions(Stylesheet &s,
+                                     ProcessingContext &context) {
+  std::list<Extension>* extensions = &context.getExtensions();
   std::list<Ruleset*>::iterator r_it;
   std::list<Extension>::iterator e_it;
 
+  for (r_it = s.getRulesets().begin();
+       r_it != s.getRulesets().end();
+       r_it++) {
+    for (e_it = extensions->begin();
+         e_it != extensions->end();
+         e_it++) {
+      (*e_it).updateSelector((*r_it)->getSelector());
+    }
+  }
+}
+
+void LessStylesheet::process(Stylesheet &s, ProcessingContext &context) {
   context.pushScope(variables);
 
   this->context = &context;
@@ -103,17 +189,37 @@ void LessStylesheet::process(Stylesheet &s, ProcessingContext &context) {
 
   context.popScope();
 
-
   // post processing
-  extensions = &context.getExtensions();
+  applyExtensions(s, context);
+}
 
-  for (r_it = s.getRulesets().begin();
-       r_it != s.getRulesets().end();
-       r_it++) {
-    for (e_it = extensions->begin();
-         e_it != extensions->end();
-         e_it++) {
-      (*e_it).updateSelector((*r_it)->getSelector());
+void LessStylesheet::process(Stylesheet &s, ProcessingContext &context,
+                             CssWriter &writer) {
+  std::list<StylesheetStatement*> statements = getStatements();
+  std::list<StylesheetStatement*>::iterator i;
+  StylesheetStatement* last = getLastExtendingStatement();
+  bool final = (last == NULL);
+
+#ifdef WITH_LIBGLOG
+  VLOG(1) << "Processing stylesheet, streaming output";
+#endif
+
+  context.pushScope(variables);
+  this->context = &context;
+  
+  for (i = statements.begin(); i != statements.end(); i++) {
+    if ((*i)->isReference() == false)
+      (*i)->process(s);
+
+    if (*i == last)
+      final = true;
+
+    if (final) {
+      applyExtensions(s, context);
+      s.write(writer);
+      s.clear();
     }
   }
+  
+  context.popScope();
 }
@@ -25,6 +25,7 @@
 #include "../stylesheet/Stylesheet.h"
 
 #include "../TokenList.h"
+#include "../SharedTokenList.h"
 #include "../Token.h"
 
 #include "LessRuleset.h"
@@ -35,6 +36,7 @@
 
 #include <list>
 #include <map>
+#include <set>
 #include <string>
 
 class LessMediaQuery;
@@ -42,8 +44,26 @@ class LessMediaQuery;
 class LessStylesheet: public Stylesheet {
 private:
   std::list<LessRuleset*> lessrulesets;
-  std::map<std::string, TokenList> variables;
+  std::list<LessMediaQuery*> lessmediaqueries;
+  std::map<std::string, SharedTokenList> variables;
   ProcessingContext* context;
+
+  /**
+   * Statements that belong to another stylesheet, see
+   * borrowStatement().
+   */
+  std::set<StylesheetStatement*> borrowed;
+
+  void applyExtensions(Stylesheet &s, ProcessingContext &context);
+
+  /**
+   * Find the last statement that may add extensions when it is
+   * processed. Output of the statements after it can be written as
+   * soon as it is generated.
+   *
+   * @return the statement or NULL if the stylesheet has no extensions.
+   */
+  StylesheetStatement* getLastExtendingStatement();
   
 public:
   LessStylesheet();
@@ -56,6 +76,13 @@ public:
 
   void deleteLessRuleset(LessRuleset &ruleset);
   void deleteMixin(Mixin &mixin);
+
+  /**
+   * Add a statement of another stylesheet to the end of this one
+   * without taking ownership of it. The statement is not changed; it
+   * keeps referring to its own stylesheet.
+   */
+  void borrowStatement(StylesheetStatement &statement);
   
   virtual void getLessRulesets(std::list<LessRuleset*> &rulesetList,
                                const Mixin &mixin);
@@ -63,10 +90,25 @@ public:
   void setContext(ProcessingContext* context);
   virtual ProcessingContext* getContext();
   
-  void putVariable(const std::string &key, const TokenList &value);
+  virtual void putVariable(const std::string &key,
+                           const SharedTokenList &value);
+
+  /**
+   * Check if any of the rulesets or media queries contain extensions.
+   */
+  bool hasExtensions();
 
   virtual void process(Stylesheet &s, ProcessingContext &context);
 
+  /**
+   * Process the stylesheet and write the output to writer while
+   * processing. Output statements are written and deleted as soon as
+   * no extension can change them, so s only holds the output that is
+   * still pending.
+   */
+  void process(Stylesheet &s, ProcessingContext &context,
+               CssWriter &writer);
+
   
 };
 
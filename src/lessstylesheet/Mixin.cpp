@@ -1,6 +1,7 @@
 #include "Mixin.h"
 #include "LessStylesheet.h"
 #include "LessRuleset.h"
+#include "MixinFrame.h"
 
 #include <config.h>
 
@@ -19,7 +20,7 @@ Mixin::Mixin(const Selector &name) {
 Mixin::~Mixin() {
 }
 
-const TokenList* Mixin::getArgument(const size_t i) const {
+const SharedTokenList* Mixin::getArgument(const size_t i) const {
   if (i < arguments.size())
     return &arguments[i];
   else
@@ -28,8 +29,8 @@ const TokenList* Mixin::getArgument(const size_t i) const {
 size_t Mixin::getArgumentCount() const {
   return arguments.size();
 }
-const TokenList* Mixin::getArgument(const string &name) const{
-  map<string, TokenList>::const_iterator i;
+const SharedTokenList* Mixin::getArgument(const string &name) const{
+  map<string, SharedTokenList>::const_iterator i;
 
   i = namedArguments.find(name);
   
@@ -59,11 +60,9 @@ bool Mixin::parse(const Selector &selector) {
 bool Mixin::insert(Stylesheet &s, ProcessingContext &context,
                    Ruleset* target, LessRuleset* parent) {
 
-  vector<TokenList>::iterator arg_i;
-  map<string, TokenList>::iterator argn_i;
-  list<LessRuleset*>::iterator i;
+  vector<SharedTokenList>::iterator arg_i;
+  map<string, SharedTokenList>::iterator argn_i;
   list<LessRuleset*> rulesetList;
-  LessRuleset* lessruleset;
 
 #ifdef WITH_LIBGLOG
   VLOG(2) << "Mixin: \"" << name.toString() << "\"";
@@ -79,7 +78,7 @@ bool Mixin::insert(Stylesheet &s, ProcessingContext &context,
   
   for (arg_i = arguments.begin(); arg_i != arguments.end(); arg_i++) {
 #ifdef WITH_LIBGLOG
-    VLOG(3) << "Mixin Arg: " << (*arg_i).toString();
+    VLOG(3) << "Mixin Arg: " << (*arg_i)->toString();
 #endif
     context.processValue(*arg_i);
   }
@@ -87,29 +86,14 @@ bool Mixin::insert(Stylesheet &s, ProcessingContext &context,
   for (argn_i = namedArguments.begin(); argn_i !=
          namedArguments.end(); argn_i++) {
 #ifdef WITH_LIBGLOG
-    VLOG(3) << "Mixin Arg " << argn_i->first << ": " << argn_i->second.toString();
+    VLOG(3) << "Mixin Arg " << argn_i->first << ": " << argn_i->second->toString();
 #endif
     context.processValue(argn_i->second);
   }
   
 
-  for (i = rulesetList.begin(); i != rulesetList.end(); i++) {
-    lessruleset = *i;
-
-#ifdef WITH_LIBGLOG
-    VLOG(3) << "Mixin: " << lessruleset->getSelector().toString();
-#endif
-
-    if (lessruleset->getLessSelector()->needsArguments() ||
-        !context.isInStack(*lessruleset)) {
-      if (target != NULL)
-        lessruleset->insert(this, *target, context);
-      else
-        lessruleset->insert(this, s, context);
-    }
-  }
-
-  return !rulesetList.empty();
+  context.pushFrame(new MixinFrame(*this, rulesetList, s, target));
+  return true;
 }
 
 void Mixin::setLessStylesheet(LessStylesheet &s) {
@@ -123,7 +107,11 @@ LessStylesheet* Mixin::getLessStylesheet() {
 
 
 void Mixin::process(Stylesheet &s) {
-  insert(s, *getLessStylesheet()->getContext(), NULL, NULL);
+  // The arguments are replaced with their processed values so insert a
+  // copy; only the references to the argument tokens are copied.
+  Mixin call(*this);
+  
+  call.insert(s, *getLessStylesheet()->getContext(), NULL, NULL);
 }
 
 void Mixin::parseArguments(TokenList::const_iterator i, const Selector &selector) {
@@ -188,7 +176,7 @@ void Mixin::parseArguments(TokenList::const_iterator i, const Selector &selector
       this->arguments.push_back(argument);
     else {
       this->namedArguments.insert(pair<string,
-                                  TokenList>(argName,argument));
+                                  SharedTokenList>(argName,argument));
       argName = "";
     }
     argument.clear();
@@ -30,6 +30,7 @@
 #include "../css/CssWriter.h"
 
 #include "../TokenList.h"
+#include "../SharedTokenList.h"
 
 #include "ProcessingContext.h"
 #include <vector>
@@ -41,8 +42,8 @@ class LessRuleset;
 
 class Mixin: public StylesheetStatement{
 private:
-  vector<TokenList> arguments;
-  map<std::string, TokenList> namedArguments;
+  vector<SharedTokenList> arguments;
+  map<std::string, SharedTokenList> namedArguments;
 
   LessStylesheet* lessStylesheet;
   void parseArguments(TokenList::const_iterator i, const Selector &s);
@@ -54,10 +55,10 @@ public:
   Mixin(const Selector &name);
   virtual ~Mixin() ;
   
-  const TokenList* getArgument(const size_t i) const;
+  const SharedTokenList* getArgument(const size_t i) const;
   size_t getArgumentCount() const;
   
-  const TokenList* getArgument(const string &name) const;
+  const SharedTokenList* getArgument(const string &name) const;
 
   bool insert(Stylesheet &s, ProcessingContext &context,
               Ruleset* ruleset, LessRuleset* parent);
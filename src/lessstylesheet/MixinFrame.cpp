@@ -0,0 +1,69 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "MixinFrame.h"
+#include "LessRuleset.h"
+
+#include <config.h>
+
+#ifdef WITH_LIBGLOG
+#include <glog/logging.h>
+#endif
+
+MixinFrame::MixinFrame(const Mixin &mixin, std::list<LessRuleset*> &rulesets,
+                       Stylesheet &s, Ruleset* target): mixin(mixin) {
+  this->rulesets.swap(rulesets);
+  ruleset = this->rulesets.begin();
+  stylesheet = &s;
+  this->target = target;
+}
+
+MixinFrame::~MixinFrame() {
+}
+
+Mixin& MixinFrame::getMixin() {
+  return mixin;
+}
+
+bool MixinFrame::next(ProcessingContext &context) {
+  LessRuleset* lessruleset;
+
+  // Rulesets that are already being inserted are skipped, unless they
+  // take arguments, to prevent infinite recursion.
+  while (ruleset != rulesets.end()) {
+    lessruleset = *ruleset;
+    ruleset++;
+    
+#ifdef WITH_LIBGLOG
+    VLOG(3) << "Mixin: " << lessruleset->getSelector().toString();
+#endif
+
+    if (lessruleset->getLessSelector()->needsArguments() ||
+        !context.isInStack(*lessruleset)) {
+      if (target != NULL)
+        lessruleset->insert(&mixin, *target, context);
+      else
+        lessruleset->insert(&mixin, *stylesheet, context);
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __MixinFrame_h__
+#define __MixinFrame_h__
+
+#include "ProcessingFrame.h"
+#include "Mixin.h"
+#include "../stylesheet/Stylesheet.h"
+#include "../stylesheet/Ruleset.h"
+
+#include <list>
+
+class LessRuleset;
+
+/**
+ * Inserts the rulesets that match a mixin call, one ruleset in each
+ * call to next(). The frame keeps its own copy of the mixin with the
+ * processed arguments.
+ */
+class MixinFrame: public ProcessingFrame {
+private:
+  Mixin mixin;
+  std::list<LessRuleset*> rulesets;
+  std::list<LessRuleset*>::iterator ruleset;
+  Stylesheet* stylesheet;
+  Ruleset* target;
+  
+public:
+  MixinFrame(const Mixin &mixin, std::list<LessRuleset*> &rulesets,
+             Stylesheet &s, Ruleset* target);
+  virtual ~MixinFrame();
+
+  Mixin& getMixin();
+  
+  virtual bool next(ProcessingContext &context);
+};
+
+#endif
@@ -21,6 +21,9 @@
 
 #include "ProcessingContext.h"
 #include "LessRuleset.h"
+#include "ProcessingFrame.h"
+
+#include <algorithm>
 
 #include <config.h>
 
@@ -30,13 +33,14 @@
 
 ProcessingContext::ProcessingContext() {
   scopes = NULL;
+  trackLocations = true;
 }
   
 const TokenList* ProcessingContext::getVariable(const std::string &key) {
   return scopes->getVariable(key);
 }
 void ProcessingContext::pushScope(const std::map<std::string,
-                                  TokenList> &scope) {
+                                  SharedTokenList> &scope) {
   if (scopes == NULL)
     scopes = new ValueScope(scope);
   else
@@ -58,6 +62,7 @@ void ProcessingContext::pushRuleset(const LessRuleset &ruleset) {
 #endif
   
   rulesets.push_back(&ruleset);
+  rulesetCount[&ruleset]++;
 }
 
 void ProcessingContext::popRuleset() {
@@ -65,17 +70,54 @@ void ProcessingContext::popRuleset() {
   VLOG(2) << "Pop: " << rulesets.back()->getSelector().toString();
 #endif
 
+  std::unordered_map<const LessRuleset*, unsigned int>::iterator i =
+    rulesetCount.find(rulesets.back());
+
+  if (--i->second == 0)
+    rulesetCount.erase(i);
   rulesets.pop_back();
 }
 
 bool ProcessingContext::isInStack(const LessRuleset &ruleset) {
-  std::list<const LessRuleset*>::iterator i;
+  return rulesetCount.find(&ruleset) != rulesetCount.end();
+}
+
+void ProcessingContext::pushFrame(ProcessingFrame* frame) {
+  const ValueScope* outerScope = scopes;
+  size_t outerRulesets = rulesets.size();
+  size_t size;
+  
+  frames.push_back(frame);
+  if (frames.size() > 1)
+    return;
 
-  for(i = rulesets.begin(); i != rulesets.end(); i++) {
-    if (*i == &ruleset)
-      return true;
+  try {
+    while (!frames.empty()) {
+      size = frames.size();
+      
+      if (frames.back()->next(*this)) {
+        // frames pushed in the same step run in the order they were
+        // pushed.
+        if (frames.size() > size + 1)
+          std::reverse(frames.begin() + size, frames.end());
+      } else {
+        delete frames[size - 1];
+        frames.erase(frames.begin() + (size - 1));
+      }
+    }
+  } catch(...) {
+    // The scopes and rulesets pushed by the frames point into them,
+    // so they are popped before the frames are deleted.
+    while (scopes != outerScope)
+      popScope();
+    while (rulesets.size() > outerRulesets)
+      popRuleset();
+    while (!frames.empty()) {
+      delete frames.back();
+      frames.pop_back();
+    }
+    throw;
   }
-  return false;
 }
 
 void ProcessingContext::addExtension(Extension& extension){
@@ -89,6 +131,13 @@ ValueProcessor* ProcessingContext::getValueProcessor() {
   return &processor;
 }
 
+void ProcessingContext::setTrackLocations(bool b) {
+  trackLocations = b;
+}
+bool ProcessingContext::isTrackingLocations() const {
+  return trackLocations;
+}
+
 void ProcessingContext::interpolate(TokenList &tokens) {
   processor.interpolate(tokens, *scopes);
 }
@@ -100,6 +149,10 @@ void ProcessingContext::processValue(TokenList& value) {
   processor.processValue(value, *scopes);
 }
 
-bool ProcessingContext::validateCondition(TokenList &value) {
+void ProcessingContext::processValue(SharedTokenList& value) {
+  processor.processValue(value, *scopes);
+}
+
+bool ProcessingContext::validateCondition(const TokenList &value) {
   return processor.validateCondition(value, *scopes);
 }
@@ -25,6 +25,8 @@
 #include <map>
 #include <string>
 #include <list>
+#include <vector>
+#include <unordered_map>
 
 #include "../TokenList.h"
 #include "../value/ValueScope.h"
@@ -32,34 +34,58 @@
 #include "../lessstylesheet/Extension.h"
 
 class LessRuleset;
+class ProcessingFrame;
 
 class ProcessingContext {
 private:
   const ValueScope* scopes;
-  std::list<const LessRuleset*> rulesets;
+  std::vector<const LessRuleset*> rulesets;
+  std::unordered_map<const LessRuleset*, unsigned int> rulesetCount;
+  std::vector<ProcessingFrame*> frames;
   ValueProcessor processor;
   std::list<Extension> extensions;
+  bool trackLocations;
   
 public:
   ProcessingContext();
   
   const TokenList* getVariable(const std::string &key);
-  void pushScope(const std::map<std::string, TokenList> &scope);
+  void pushScope(const std::map<std::string, SharedTokenList> &scope);
   void popScope();
   
   void pushRuleset(const LessRuleset &ruleset);
   void popRuleset();
   bool isInStack(const LessRuleset &ruleset);
 
+  /**
+   * Push a frame on the stack and take ownership of it. If the stack
+   * was empty the frames are processed until the stack is empty
+   * again, otherwise the frame is processed after the frame that is
+   * currently running returns from ProcessingFrame::next().
+   *
+   * If processing throws an exception, the scopes and rulesets that
+   * the frames pushed are popped and the frames are deleted before
+   * the exception is passed on, so the context can still be used.
+   */
+  void pushFrame(ProcessingFrame* frame);
+
   void addExtension(Extension& extension);
   std::list<Extension>& getExtensions();
 
   ValueProcessor* getValueProcessor();
 
+  /**
+   * When disabled the source locations of generated tokens are not
+   * updated. This is only needed when writing a source map.
+   */
+  void setTrackLocations(bool b);
+  bool isTrackingLocations() const;
+
   void interpolate(TokenList &tokens);
   void interpolate(std::string &str);
   void processValue(TokenList& value);
-  bool validateCondition(TokenList &value);
+  void processValue(SharedTokenList& value);
+  bool validateCondition(const TokenList &value);
 };
 
 #endif
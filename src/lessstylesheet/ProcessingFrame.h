@@ -0,0 +1,48 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __ProcessingFrame_h__
+#define __ProcessingFrame_h__
+
+class ProcessingContext;
+
+/**
+ * A unit of work on the stack of a ProcessingContext. Mixins and
+ * nested rules are inserted by pushing frames on a heap allocated
+ * stack instead of by recursive calls, so deeply recursive mixins (like
+ * loops) can't exhaust the call stack.
+ */
+class ProcessingFrame {
+public:
+  virtual ~ProcessingFrame() {};
+
+  /**
+   * Process the next part of the frame. Frames that are pushed on the
+   * stack during the call are completed before next() is called
+   * again.
+   *
+   * @return false when the frame is done. No frames should be pushed
+   *         in the call that returns false.
+   */
+  virtual bool next(ProcessingContext &context) = 0;
+};
+
+#endif
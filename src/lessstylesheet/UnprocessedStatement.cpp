@@ -32,6 +32,12 @@
 
 UnprocessedStatement::UnprocessedStatement() {
   property_i = 0;
+  sharedDeclaration = NULL;
+}
+
+UnprocessedStatement::~UnprocessedStatement() {
+  if (sharedDeclaration != NULL)
+    sharedDeclaration->release();
 }
 
 Selector* UnprocessedStatement::getTokens(){
@@ -93,6 +99,11 @@ void UnprocessedStatement::process(Ruleset &r) {
     // Can't add @-rules to rulesets so ignore the statement.
     return;
   }
+
+  if (sharedDeclaration != NULL) {
+    r.addSharedDeclaration(*sharedDeclaration);
+    return;
+  }
   
   // process extends statement
   if (getExtension(extension.getTarget())) {
@@ -118,6 +129,12 @@ void UnprocessedStatement::process(Ruleset &r) {
         declaration->getProperty() << ": " << declaration->getValue().toString();
 #endif
 
+      if (isStatic(*declaration)) {
+        declaration->retain();
+        sharedDeclaration = declaration;
+        return;
+      }
+
       getLessRuleset()->getContext()->interpolate(declaration->getProperty());
       getLessRuleset()->getContext()->processValue(declaration->getValue());
 
@@ -151,6 +168,12 @@ bool UnprocessedStatement::isExtends() {
           (*++i).type == Token::PAREN_OPEN);
 }
 
+bool UnprocessedStatement::isMixinCall() {
+  const Token &front = getTokens()->front();
+  
+  return (front == "." || front.type == Token::HASH);
+}
+
 bool UnprocessedStatement::getExtension(TokenList &extension) {
   TokenList::iterator i;
   int parentheses = 1;
@@ -188,6 +211,15 @@ bool UnprocessedStatement::getExtension(TokenList &extension) {
   return true;
 }
 
+bool UnprocessedStatement::isStatic(Declaration &declaration) {
+  ValueProcessor* processor =
+    getLessRuleset()->getContext()->getValueProcessor();
+  
+  return (declaration.getProperty().find("@{") == string::npos &&
+          !processor->needsProcessing(declaration.getValue()) &&
+          !processor->needsInterpolation(declaration.getValue()));
+}
+
 bool UnprocessedStatement::processDeclaration (Declaration* declaration) {
   TokenList property;
   Token keyword;
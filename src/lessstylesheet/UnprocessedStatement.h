@@ -40,15 +40,23 @@ class UnprocessedStatement: public RulesetStatement {
 private:
   Selector tokens;
   LessRuleset* lessRuleset;
+
+  /**
+   * A declaration without variables, operators or functions gives the
+   * same result every time it is processed so it is kept here and
+   * shared by all the rulesets it is inserted into.
+   */
+  Declaration* sharedDeclaration;
   
 protected:
   bool processDeclaration (Declaration* declaration);
+  bool isStatic(Declaration &declaration);
   
 public:
   size_t property_i;
   
   UnprocessedStatement();
-  ~UnprocessedStatement() {}
+  virtual ~UnprocessedStatement();
 
   Selector* getTokens();
 
@@ -59,6 +67,11 @@ public:
   LessRuleset* getLessRuleset();
 
   bool isExtends();
+  /**
+   * Check if the statement calls a mixin, .mixin() or #namespace >
+   * .mixin.
+   */
+  bool isMixinCall();
   bool getExtension(TokenList &extension);
   
   void insert(Stylesheet &s);
@@ -50,9 +50,7 @@ void Declaration::process(Ruleset &r) {
   VLOG(2) << "Processing declaration " << property << ": " <<
     value.toString();
 #endif
-  Declaration* d = r.createDeclaration();
-  d->setProperty(property);
-  d->setValue(value);
+  r.addSharedDeclaration(*this);
 }
 
 
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "InlineCss.h"
+#include "../css/IOException.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <config.h>
+
+#ifdef WITH_LIBGLOG
+#include <glog/logging.h>
+#endif
+
+InlineCss::InlineCss() {
+  css = NULL;
+  length = 0;
+  mapped = false;
+}
+
+InlineCss::~InlineCss() {
+  if (mapped)
+    munmap((void*)css, length);
+}
+
+void InlineCss::load(const char* filename) {
+  struct stat st;
+  void* data;
+  int fd = open(filename, O_RDONLY);
+
+  if (fd < 0)
+    throw new IOException("Error opening inline import");
+
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw new IOException("Error reading inline import");
+  }
+
+#ifdef WITH_LIBGLOG
+  VLOG(2) << "Inline import: " << filename << " (" << st.st_size <<
+    " bytes)";
+#endif
+
+  // an empty file can not be mapped
+  if (st.st_size > 0) {
+    data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      throw new IOException("Error reading inline import");
+    }
+    css = (const char*)data;
+    length = st.st_size;
+    mapped = true;
+  }
+  close(fd);
+}
+
+void InlineCss::setCss(const char* css, size_t length) {
+  this->css = css;
+  this->length = length;
+}
+
+const char* InlineCss::getCss() {
+  return css;
+}
+
+size_t InlineCss::getLength() {
+  return length;
+}
+
+void InlineCss::process(Stylesheet &s) {
+  InlineCss* c = s.createInlineCss();
+  c->setCss(css, length);
+}
+
+void InlineCss::write(CssWriter &writer) {
+  if (length > 0)
+    writer.writeInlineCss(css, length);
+}
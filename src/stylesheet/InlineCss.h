@@ -0,0 +1,62 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __InlineCss_h__
+#define __InlineCss_h__
+
+#include "Stylesheet.h"
+#include "StylesheetStatement.h"
+#include "../css/CssWriter.h"
+
+#include <cstddef>
+
+/**
+ * CSS that is written to the output as it is, for imports with the
+ * (inline) directive. The file is mapped into memory instead of being
+ * read and tokenized.
+ */
+class InlineCss: public StylesheetStatement {
+private:
+  const char* css;
+  size_t length;
+  /**
+   * The statement that loaded the file owns the mapping. The copies
+   * made by process() borrow it.
+   */
+  bool mapped;
+
+public:
+  InlineCss();
+  virtual ~InlineCss();
+
+  /**
+   * Map the file into memory.
+   */
+  void load(const char* filename);
+  void setCss(const char* css, size_t length);
+  const char* getCss();
+  size_t getLength();
+  
+  virtual void process(Stylesheet &s);
+  virtual void write(CssWriter &writer);
+};
+
+#endif
@@ -21,6 +21,9 @@
 
 #include "MediaQuery.h"
 
+static const Token BUILTIN_AND("and", Token::IDENTIFIER, 0, 0,
+                               Token::BUILTIN_SOURCE);
+
 Selector& MediaQuery::getSelector() {
   return selector;
 }
@@ -42,12 +45,24 @@ MediaQuery* MediaQuery::createMediaQuery() {
 
 void MediaQuery::process(Stylesheet &s) {
   MediaQuery* query = s.createMediaQuery();
+  Selector inner;
     
 #ifdef WITH_LIBGLOG
   VLOG(2) << "Processing media query " << getSelector().toString();
 #endif
-      
-  query->setSelector(getSelector());
+
+  // a query nested in another query applies to both
+  if (query->getSelector().size() > 0) {
+    inner = getSelector();
+    inner.pop_front();
+
+    query->getSelector().push_back(Token::BUILTIN_SPACE);
+    query->getSelector().push_back(BUILTIN_AND);
+    query->getSelector().insert(query->getSelector().end(),
+                                inner.begin(),
+                                inner.end());
+  } else
+    query->setSelector(getSelector());
     
   Stylesheet::process(*query);
 }
@@ -21,6 +21,8 @@
 
 #include "Ruleset.h"
 
+#include <algorithm>
+
 Ruleset::Ruleset() {
 }
 Ruleset::Ruleset(const Selector &selector){
@@ -58,15 +60,84 @@ CssComment* Ruleset::createComment() {
 }
 
 void Ruleset::deleteStatement(RulesetStatement &statement) {
-  statements.remove(&statement);
-  delete &statement;
+  std::list<RulesetStatement*>::iterator s_it =
+    std::find(statements.begin(), statements.end(), &statement);
+
+  if (s_it == statements.end())
+    return;
+  statements.erase(s_it);
+  statement.release();
 }
 
 void Ruleset::deleteDeclaration(Declaration &declaration) {
-  declarations.remove(&declaration);
+  std::list<Declaration*>::iterator d_it =
+    std::find(declarations.begin(), declarations.end(), &declaration);
+
+  if (d_it == declarations.end())
+    return;
+  declarations.erase(d_it);
   deleteStatement(declaration);
 }
 
+void Ruleset::deleteDeclarations(const std::vector<bool> &positions) {
+  std::list<Declaration*>::iterator d_it = declarations.begin();
+  std::list<RulesetStatement*>::iterator s_it = statements.begin();
+  size_t i;
+
+  // The declarations are in the same order in both lists, so the
+  // statement of a declaration is the next entry of it in statements.
+  for (i = 0; d_it != declarations.end(); i++) {
+    while (*s_it != *d_it)
+      s_it++;
+    
+    if (i < positions.size() && positions[i]) {
+      (*s_it)->release();
+      s_it = statements.erase(s_it);
+      d_it = declarations.erase(d_it);
+    } else {
+      s_it++;
+      d_it++;
+    }
+  }
+}
+
+void Ruleset::addSharedDeclaration(Declaration &declaration) {
+  declaration.retain();
+  declaration.setRuleset(this);
+  declarations.push_back(&declaration);
+  statements.push_back(&declaration);
+}
+
+std::list<RulesetStatement*>::iterator
+Ruleset::findStatement(std::list<Declaration*>::iterator position) {
+  std::list<Declaration*>::iterator d_it = declarations.begin();
+  std::list<RulesetStatement*>::iterator s_it = statements.begin();
+
+  // The declarations are in the same order in both lists.
+  for (; d_it != position; d_it++, s_it++) {
+    while (*s_it != *d_it)
+      s_it++;
+  }
+  while (*s_it != *d_it)
+    s_it++;
+  return s_it;
+}
+
+Declaration* Ruleset::copyDeclaration(std::list<Declaration*>::iterator
+                                      position) {
+  Declaration* declaration = *position;
+  Declaration* d = new Declaration(declaration->getProperty());
+
+  d->setValue(declaration->getValue());
+  d->setRuleset(this);
+
+  *findStatement(position) = d;
+  *position = d;
+  
+  declaration->release();
+  return d;
+}
+
 void Ruleset::addDeclarations (std::list<Declaration> &declarations) {
   std::list<Declaration>::iterator i = declarations.begin();
   for (; i != declarations.end(); i++) {
@@ -92,13 +163,13 @@ std::list<Declaration*>& Ruleset::getDeclarations() {
 void Ruleset::clearStatements() {
   declarations.clear();
   while(!statements.empty()) {
-    delete statements.back();
+    statements.back()->release();
     statements.pop_back();
   }
 }
 
 void Ruleset::insert(Ruleset &target) {
-  std::list<RulesetStatement*> statements = getStatements();
+  std::list<RulesetStatement*>& statements = getStatements();
   std::list<RulesetStatement*>::iterator i;
   for (i = statements.begin(); i != statements.end(); i++) {
     (*i)->process(target);
@@ -117,7 +188,7 @@ void Ruleset::process(Stylesheet &s) {
 }
 
 void Ruleset::write(CssWriter &writer) {
-  std::list<RulesetStatement*> statements = getStatements();
+  std::list<RulesetStatement*>& statements = getStatements();
   std::list<RulesetStatement*>::iterator i;
 
   if (getStatements().empty())
@@ -32,6 +32,8 @@
 
 #include "../css/CssWriter.h"
 
+#include <vector>
+
 class RulesetStatement;
 class Declaration;
 
@@ -40,6 +42,13 @@ private:
   std::list<RulesetStatement*> statements;
   std::list<Declaration*> declarations;
 
+  /**
+   * The entry in statements of the declaration at position in
+   * declarations.
+   */
+  std::list<RulesetStatement*>::iterator
+  findStatement(std::list<Declaration*>::iterator position);
+
 protected:
   Selector selector;
   virtual void addStatement(RulesetStatement &statement);
@@ -55,7 +64,35 @@ public:
   Declaration* createDeclaration(const Token &property);
   CssComment* createComment();
   
+  /**
+   * Delete the first entry of the declaration.
+   */
   void deleteDeclaration(Declaration &declaration);
+  /**
+   * Delete the declarations at the positions in getDeclarations()
+   * that are true in positions, with one pass over the statements.
+   */
+  void deleteDeclarations(const std::vector<bool> &positions);
+
+  /**
+   * Add a declaration that is shared with other rulesets. The ruleset
+   * takes a reference to the declaration instead of copying it, so it
+   * must not be modified. getRuleset() of the declaration returns the
+   * ruleset that added it last.
+   *
+   * A mixin that is inserted twice adds the same declaration twice,
+   * so a ruleset can hold a shared declaration more than once.
+   * Declarations are therefore removed or replaced one entry at a
+   * time.
+   */
+  void addSharedDeclaration(Declaration &declaration);
+
+  /**
+   * Replace the declaration at position in getDeclarations() with a
+   * copy that is owned by this ruleset and can be modified. Other
+   * entries of the same declaration are left as they are.
+   */
+  Declaration* copyDeclaration(std::list<Declaration*>::iterator position);
   
   void addDeclarations (std::list<Declaration> &declarations);
 
@@ -27,3 +27,11 @@ void RulesetStatement::setRuleset(Ruleset* r) {
 Ruleset* RulesetStatement::getRuleset() {
   return ruleset;
 }
+
+void RulesetStatement::retain() {
+  references++;
+}
+void RulesetStatement::release() {
+  if (--references == 0)
+    delete this;
+}
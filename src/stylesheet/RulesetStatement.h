@@ -27,11 +27,24 @@
 class Ruleset;
 
 class RulesetStatement :  public CssWritable {
+private:
+  unsigned int references;
+  
 protected:
   Ruleset* ruleset;
 public:
+  RulesetStatement(): references(1), ruleset(NULL) {};
   virtual ~RulesetStatement() {};
 
+  /**
+   * Statements that do not change can be shared by several rulesets.
+   * Every ruleset that adds a shared statement takes a reference with
+   * retain() and release() deletes the statement once the last
+   * reference is gone.
+   */
+  void retain();
+  void release();
+
   virtual void setRuleset(Ruleset *r);
   Ruleset* getRuleset();
   virtual void process(Ruleset &r) = 0;
@@ -21,6 +21,7 @@
 
 #include "Selector.h"
 #include <iostream>
+#include <vector>
 
 #ifdef WITH_LIBGLOG
 #include <glog/logging.h>
@@ -30,58 +31,71 @@ Selector::~Selector() {
   clear();
 }
 
-void Selector::addPrefix(const Selector &prefix) {
-  list<Selector> prefixParts;
-  list<Selector> sepParts;
-  list<Selector>::iterator prefixIt;
-  list<Selector>::iterator sepIt;
-  Selector::iterator prefixPartIt;
-
-  Selector* tmp, *prefixPart;
-  TokenList::iterator i;
+void Selector::addPrefix(const Selector &prefix, bool updateLocation) {
+  std::vector<const_iterator> prefixParts;
+  std::vector<const_iterator>::iterator prefixIt;
+  const_iterator first, last, prefixLast, i;
+  iterator inserted;
+  Selector result;
   bool containsAmp;
 
-  split(sepParts);
-  prefix.split(prefixParts);
+  // Record the boundaries of the prefix parts instead of copying them.
+  for (first = prefix.begin(); first != prefix.end(); ) {
+    prefixParts.push_back(first);
+    first = prefix.findComma(first);
+    if (first != prefix.end())
+      first++;
+  }
   
-  clear();
-
-  for (sepIt = sepParts.begin();
-       sepIt != sepParts.end(); sepIt++) {
-
-    tmp = &(*sepIt);
-    tmp->ltrim();
-    containsAmp = tmp->contains(Token::OTHER, "&");
-
-    for (prefixIt = prefixParts.begin();
-         prefixIt != prefixParts.end(); prefixIt++) {
+  for (first = begin(); first != end(); ) {
+    last = findComma(first);
+    
+    while (first != last && (*first).type == Token::WHITESPACE)
+      first++;
 
-      prefixPart = &(*prefixIt);
+    containsAmp = false;
+    for (i = first; i != last && !containsAmp; i++) {
+      containsAmp = ((*i).type == Token::OTHER && *i == "&");
+    }
 
-      for (prefixPartIt = prefixPart->begin();
-           prefixPartIt != prefixPart->end();
-           prefixPartIt++) {
-        (*prefixPartIt).setLocation(tmp->front());
-      }
+    for (prefixIt = prefixParts.begin(); prefixIt != prefixParts.end();
+         prefixIt++) {
+      prefixLast = prefix.findComma(*prefixIt);
       
       if (containsAmp) {
         
-        for (i = tmp->begin(); i != tmp->end(); i++) {
-          if (*i == "&")
-            insert(end(), prefixPart->begin(), prefixPart->end());
-          else
-            push_back(*i);
+        for (i = first; i != last; i++) {
+          if (*i == "&") {
+            inserted = result.insert(result.end(), *prefixIt, prefixLast);
+            if (updateLocation && first != last)
+              setLocation(inserted, result.end(), *first);
+          } else
+            result.push_back(*i);
         }
-
       } else {
-        insert(end(), prefixPart->begin(), prefixPart->end());
-        push_back(Token::BUILTIN_SPACE);
-        insert(end(), tmp->begin(), tmp->end());
+        inserted = result.insert(result.end(), *prefixIt, prefixLast);
+        if (updateLocation && first != last)
+          setLocation(inserted, result.end(), *first);
+
+        result.push_back(Token::BUILTIN_SPACE);
+        result.insert(result.end(), first, last);
       }
-      push_back(Token::BUILTIN_COMMA);
+      result.push_back(Token::BUILTIN_COMMA);
     }
+
+    first = last;
+    if (first != end())
+      first++;
   }
-  pop_back();
+  if (!result.empty())
+    result.pop_back();
+  swap(result);
+}
+
+void Selector::setLocation(iterator first, iterator last,
+                           const Token &ref) {
+  for (; first != last; first++)
+    (*first).setLocation(ref);
 }
 
 void Selector::split(std::list<Selector> &l) const {
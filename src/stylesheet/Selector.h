@@ -32,7 +32,16 @@ class Selector: public TokenList {
 public:
   virtual ~Selector();
 
-  void addPrefix(const Selector &prefix);
+  /**
+   * Combine the selector with a parent selector. Every comma separated
+   * part is combined with every part of the prefix, replacing '&'
+   * where it occurs.
+   *
+   * The tokens copied from the prefix only get the location of the
+   * nested part when updateLocation is set, which is only of use when
+   * generating a source map.
+   */
+  void addPrefix(const Selector &prefix, bool updateLocation = true);
 
   /**
    * If the selector contains commas then it is split up into multiple
@@ -56,6 +65,9 @@ public:
 
   const_iterator findComma(const_iterator offset) const;
   const_iterator findComma(const_iterator offset, const_iterator limit) const;
+
+private:
+  void setLocation(iterator first, iterator last, const Token &ref);
 };
 
 #endif
@@ -29,14 +29,43 @@
 
 
 Stylesheet::~Stylesheet() {
+  clear();
+}
+
+void Stylesheet::clear() {
   rulesets.clear();
   atrules.clear();
+  mediaqueries.clear();
   while(!statements.empty()) {
     delete statements.back();
     statements.pop_back();
   }
 }
 
+void Stylesheet::prependStatements(Stylesheet &source) {
+  std::list<StylesheetStatement*>::iterator i;
+
+  for (i = source.statements.begin(); i != source.statements.end(); i++) {
+    (*i)->setStylesheet(this);
+  }
+  statements.splice(statements.begin(), source.statements);
+  rulesets.splice(rulesets.begin(), source.rulesets);
+  atrules.splice(atrules.begin(), source.atrules);
+  mediaqueries.splice(mediaqueries.begin(), source.mediaqueries);
+}
+
+void Stylesheet::appendStatements(Stylesheet &source) {
+  std::list<StylesheetStatement*>::iterator i;
+
+  for (i = source.statements.begin(); i != source.statements.end(); i++) {
+    (*i)->setStylesheet(this);
+  }
+  statements.splice(statements.end(), source.statements);
+  rulesets.splice(rulesets.end(), source.rulesets);
+  atrules.splice(atrules.end(), source.atrules);
+  mediaqueries.splice(mediaqueries.end(), source.mediaqueries);
+}
+
 void Stylesheet::addStatement(StylesheetStatement &statement) {
   statements.push_back(&statement);
   statement.setStylesheet(this);
@@ -97,6 +126,12 @@ CssComment* Stylesheet::createComment() {
   return c;
 }
 
+InlineCss* Stylesheet::createInlineCss() {
+  InlineCss* c = new InlineCss();
+  addStatement(*c);
+  return c;
+}
+
 MediaQuery* Stylesheet::createMediaQuery() {
   MediaQuery* q = new MediaQuery();
 
@@ -105,6 +140,7 @@ MediaQuery* Stylesheet::createMediaQuery() {
 #endif
   
   addStatement(*q);
+  mediaqueries.push_back(q);
   return q;
 }
 
@@ -122,6 +158,7 @@ void Stylesheet::deleteAtRule(AtRule &atrule) {
   deleteStatement(atrule);
 }
 void Stylesheet::deleteMediaQuery(MediaQuery &query) {
+  mediaqueries.remove(&query);
   deleteStatement(query);
 }
 
@@ -131,6 +168,9 @@ std::list<AtRule*>& Stylesheet::getAtRules() {
 std::list<Ruleset*>& Stylesheet::getRulesets() {
   return rulesets;
 }
+std::list<MediaQuery*>& Stylesheet::getMediaQueries() {
+  return mediaqueries;
+}
 std::list<StylesheetStatement*>& Stylesheet::getStatements() {
   return statements;
 }
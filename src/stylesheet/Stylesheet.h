@@ -37,11 +37,13 @@ class Ruleset;
 class StylesheetStatement;
 class CssComment;
 class MediaQuery;
+class InlineCss;
 
 class Stylesheet: public CssWritable {
 private:
   std::list<AtRule*> atrules;
   std::list<Ruleset*> rulesets;
+  std::list<MediaQuery*> mediaqueries;
   std::list<StylesheetStatement*> statements;
 
 protected:
@@ -61,13 +63,30 @@ public:
   virtual MediaQuery* createMediaQuery();
 
   CssComment* createComment();
+  InlineCss* createInlineCss();
   
   void deleteRuleset(Ruleset &ruleset);
   void deleteAtRule(AtRule &atrule);
   void deleteMediaQuery(MediaQuery &query);
+  /**
+   * Delete all statements.
+   */
+  void clear();
+
+  /**
+   * Move the statements of source to the start of this stylesheet,
+   * keeping their order.
+   */
+  void prependStatements(Stylesheet &source);
+  /**
+   * Move the statements of source to the end of this stylesheet,
+   * keeping their order.
+   */
+  void appendStatements(Stylesheet &source);
   
   std::list<AtRule*>& getAtRules();
   std::list<Ruleset*>& getRulesets();
+  std::list<MediaQuery*>& getMediaQueries();
   std::list<StylesheetStatement*>& getStatements();
   
   virtual Ruleset* getRuleset(const Selector& selector);
@@ -81,5 +100,6 @@ public:
 #include "Ruleset.h"
 #include "CssComment.h"
 #include "MediaQuery.h"
+#include "InlineCss.h"
 
 #endif
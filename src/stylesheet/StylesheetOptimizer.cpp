@@ -0,0 +1,903 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "StylesheetOptimizer.h"
+
+#include <config.h>
+
+#include <iostream>
+#include <map>
+
+#ifdef WITH_LIBGLOG
+#include <glog/logging.h>
+#endif
+
+/**
+ * The longhands of box shorthands are in top, right, bottom, left
+ * order.
+ */
+struct Shorthand {
+  const char* name;
+  bool box;
+  const char* longhands[8];
+};
+
+static const Shorthand SHORTHANDS[] = {
+  {"margin", true, {"margin-top", "margin-right", "margin-bottom",
+                    "margin-left"}},
+  {"padding", true, {"padding-top", "padding-right", "padding-bottom",
+                     "padding-left"}},
+  {"border-width", true, {"border-top-width", "border-right-width",
+                          "border-bottom-width", "border-left-width"}},
+  {"border-style", true, {"border-top-style", "border-right-style",
+                          "border-bottom-style", "border-left-style"}},
+  {"border-color", true, {"border-top-color", "border-right-color",
+                          "border-bottom-color", "border-left-color"}},
+  {"border-radius", true, {"border-top-left-radius",
+                           "border-top-right-radius",
+                           "border-bottom-right-radius",
+                           "border-bottom-left-radius"}},
+  {"inset", true, {"top", "right", "bottom", "left"}},
+  {"background", false, {"background-color", "background-image",
+                         "background-repeat", "background-attachment",
+                         "background-position", "background-size",
+                         "background-origin", "background-clip"}}
+};
+#define SHORTHAND_COUNT (sizeof(SHORTHANDS) / sizeof(Shorthand))
+
+/**
+ * Shorthands, and current names of legacy properties, that set
+ * properties with a different name than their own. Other longhands
+ * start with the name of their shorthand and are in its family
+ * already.
+ */
+struct ShorthandFamily {
+  const char* shorthand;
+  const char* longhands[6];
+};
+
+static const ShorthandFamily SHORTHAND_FAMILIES[] = {
+  {"font", {"line-height"}},
+  {"inset", {"top", "right", "bottom", "left"}},
+  {"place-content", {"align-content", "justify-content"}},
+  {"place-items", {"align-items", "justify-items"}},
+  {"place-self", {"align-self", "justify-self"}},
+  {"gap", {"row-gap", "column-gap", "grid-gap", "grid-row-gap",
+           "grid-column-gap"}},
+  {"grid-gap", {"gap", "row-gap", "column-gap"}},
+  {"row-gap", {"grid-row-gap"}},
+  {"column-gap", {"grid-column-gap"}},
+  {"columns", {"column-width", "column-count"}},
+  {"white-space", {"text-wrap", "text-wrap-mode"}},
+  {"vertical-align", {"alignment-baseline", "baseline-shift",
+                      "baseline-source"}},
+  {"overflow-wrap", {"word-wrap"}},
+  {"break-before", {"page-break-before"}},
+  {"break-after", {"page-break-after"}},
+  {"break-inside", {"page-break-inside"}},
+  // these set the width or the height, depending on the writing mode
+  {"inline-size", {"width", "height"}},
+  {"block-size", {"width", "height"}}
+};
+#define SHORTHAND_FAMILY_COUNT (sizeof(SHORTHAND_FAMILIES) /     \
+                                sizeof(ShorthandFamily))
+
+/**
+ * 'all' resets every property, so nothing can be moved past it.
+ */
+#define ALL_FAMILY "all"
+
+/**
+ * At-rules with a block that holds descriptors or keyframes instead
+ * of style rules.
+ */
+static const char* DESCRIPTOR_RULES[] = {
+  "font-face", "keyframes", "page", "counter-style", "property",
+  "font-feature-values", "font-palette-values", NULL
+};
+
+StylesheetOptimizer::StylesheetOptimizer() {
+}
+
+StylesheetOptimizer::~StylesheetOptimizer() {
+}
+
+void StylesheetOptimizer::optimize(Stylesheet &s) {
+  std::vector<Ruleset*> rulesets;
+  std::vector<Ruleset*>::iterator r_it;
+  std::list<MediaQuery*>::iterator m_it;
+
+  getRulesets(s, rulesets);
+
+  mergeSelectors(s, rulesets);
+
+  for (r_it = rulesets.begin(); r_it != rulesets.end(); r_it++) {
+    if (*r_it == NULL)
+      continue;
+    
+    removeOverridden(**r_it);
+    if (compactShorthands(**r_it))
+      removeOverridden(**r_it);
+    shortenBoxValues(**r_it);
+  }
+
+  groupDeclarations(s, rulesets);
+
+  for (m_it = s.getMediaQueries().begin();
+       m_it != s.getMediaQueries().end(); m_it++) {
+    optimize(**m_it);
+  }
+}
+
+void StylesheetOptimizer::mergeMediaQueries(Stylesheet &s) {
+  std::vector<Ruleset*> rulesets;
+  std::vector<MediaQuery*> queries;
+  std::vector<std::set<std::string> > families;
+  // query -> indexes of the media queries
+  std::map<std::string, std::vector<size_t> > groups;
+  std::map<std::string, std::vector<size_t> >::iterator g_it;
+  std::list<Ruleset*>::iterator r_it;
+  std::list<StylesheetStatement*>::iterator s_it;
+  std::list<AtRule*>::iterator a_it;
+  std::vector<bool> merged;
+  size_t i, j, k, last;
+  bool safe;
+  const Token* t;
+
+  getRulesets(s, rulesets);
+  getMediaQueries(s, queries);
+  families.resize(rulesets.size());
+  merged.resize(rulesets.size(), false);
+
+  for (i = 0, s_it = s.getStatements().begin(); i < rulesets.size();
+       i++, s_it++) {
+    if (rulesets[i] != NULL)
+      getFamilies(*rulesets[i], families[i]);
+    else if (queries[i] != NULL) {
+      for (r_it = queries[i]->getRulesets().begin();
+           r_it != queries[i]->getRulesets().end(); r_it++) {
+        getFamilies(**r_it, families[i]);
+      }
+      for (a_it = queries[i]->getAtRules().begin();
+           a_it != queries[i]->getAtRules().end(); a_it++) {
+        if (!canMovePast(**a_it))
+          families[i].insert(ALL_FAMILY);
+      }
+      groups[queries[i]->getSelector().toString()].push_back(i);
+      
+    } else if (!canMovePast(**s_it))
+      families[i].insert(ALL_FAMILY);
+  }
+
+  for (g_it = groups.begin(); g_it != groups.end(); g_it++) {
+    std::vector<size_t> &group = g_it->second;
+    
+    if (group.size() < 2)
+      continue;
+    last = group.back();
+
+    // Going backwards, so the queries in between that are merged are
+    // known. Those move along and keep their order.
+    for (j = group.size() - 1; j > 0; j--) {
+      i = group[j - 1];
+      safe = true;
+
+      for (k = i + 1; safe && k < last; k++) {
+        if (!merged[k] && intersects(families[i], families[k]))
+          safe = false;
+      }
+      
+      if (!safe) {
+        // point at the first declaration, or at the query if it only
+        // has at-rules
+        t = &queries[i]->getSelector().front();
+        for (r_it = queries[i]->getRulesets().begin();
+             r_it != queries[i]->getRulesets().end(); r_it++) {
+          if (!(*r_it)->getDeclarations().empty()) {
+            t = &(*r_it)->getDeclarations().front()->getProperty();
+            break;
+          }
+        }
+        
+#ifdef WITH_LIBGLOG
+        LOG(WARNING) << t->source << ": Line " << t->line << ", Column " <<
+          t->column << " Warning: Not merging " << g_it->first <<
+          " with the one after it; a rule in between sets the same " <<
+          "properties.";
+#else
+        std::cerr << t->source << ": Line " << t->line << ", Column " <<
+          t->column << " Warning: Not merging " << g_it->first <<
+          " with the one after it; a rule in between sets the same " <<
+          "properties.\n";
+#endif
+        continue;
+      }
+
+      merged[i] = true;
+      // Queries of other groups that are checked later have to know
+      // what moved into this one.
+      families[last].insert(families[i].begin(), families[i].end());
+      queries[last]->prependStatements(*queries[i]);
+      s.deleteMediaQuery(*queries[i]);
+    }
+  }
+}
+
+void StylesheetOptimizer::getRulesets(Stylesheet &s,
+                                      std::vector<Ruleset*> &rulesets) {
+  std::list<StylesheetStatement*>::iterator s_it;
+  std::list<Ruleset*>::iterator r_it = s.getRulesets().begin();
+
+  // The rulesets are in the same order as the statements.
+  for (s_it = s.getStatements().begin(); s_it != s.getStatements().end();
+       s_it++) {
+    if (r_it != s.getRulesets().end() && *s_it == *r_it) {
+      rulesets.push_back(*r_it);
+      r_it++;
+    } else
+      rulesets.push_back(NULL);
+  }
+}
+
+void StylesheetOptimizer::getMediaQueries(Stylesheet &s,
+                                          std::vector<MediaQuery*>
+                                          &queries) {
+  std::list<StylesheetStatement*>::iterator s_it;
+  std::list<MediaQuery*>::iterator m_it = s.getMediaQueries().begin();
+
+  for (s_it = s.getStatements().begin(); s_it != s.getStatements().end();
+       s_it++) {
+    if (m_it != s.getMediaQueries().end() && *s_it == *m_it) {
+      queries.push_back(*m_it);
+      m_it++;
+    } else
+      queries.push_back(NULL);
+  }
+}
+
+void StylesheetOptimizer::getFamilies(Ruleset &r,
+                                      std::set<std::string> &families) {
+  std::list<Declaration*>::iterator d_it;
+
+  for (d_it = r.getDeclarations().begin();
+       d_it != r.getDeclarations().end(); d_it++) {
+    getFamilies((*d_it)->getProperty(), families);
+  }
+}
+
+bool StylesheetOptimizer::intersects(const std::set<std::string> &a,
+                                     const std::set<std::string> &b) {
+  std::set<std::string>::const_iterator a_it = a.begin(), b_it = b.begin();
+
+  if ((!a.empty() && b.find(ALL_FAMILY) != b.end()) ||
+      (!b.empty() && a.find(ALL_FAMILY) != a.end()))
+    return true;
+
+  while (a_it != a.end() && b_it != b.end()) {
+    if (*a_it < *b_it)
+      a_it++;
+    else if (*b_it < *a_it)
+      b_it++;
+    else
+      return true;
+  }
+  return false;
+}
+
+bool StylesheetOptimizer::canMovePast(StylesheetStatement &statement) {
+  AtRule* atrule;
+  std::string keyword;
+  size_t i;
+
+  if (dynamic_cast<CssComment*>(&statement) != NULL)
+    return true;
+
+  atrule = dynamic_cast<AtRule*>(&statement);
+  if (atrule == NULL)
+    return false;
+
+  if (!atrule->getRule().contains(Token::BRACKET_OPEN, "{"))
+    return true;
+
+  keyword = getName(atrule->getKeyword().substr(1));
+  for (i = 0; DESCRIPTOR_RULES[i] != NULL; i++) {
+    if (keyword == DESCRIPTOR_RULES[i])
+      return true;
+  }
+  return false;
+}
+
+bool StylesheetOptimizer::canMerge(Ruleset &r) {
+  const Selector &selector = r.getSelector();
+  
+  // @font-face, @page, etc. can't be combined, and a browser that
+  // does not know a prefixed selector drops the whole selector list.
+  return (!selector.empty() &&
+          selector.front().type != Token::ATKEYWORD &&
+          !hasVendorPrefix(selector) &&
+          !r.getDeclarations().empty() &&
+          r.getDeclarations().size() == r.getStatements().size());
+}
+
+void StylesheetOptimizer::mergeSelectors(Stylesheet &s,
+                                         std::vector<Ruleset*> &rulesets) {
+  std::vector<Ruleset*>::iterator r_it;
+  std::list<Declaration*>::iterator d_it;
+  Ruleset* previous = NULL;
+
+  for (r_it = rulesets.begin(); r_it != rulesets.end(); r_it++) {
+    if (*r_it == NULL || !canMerge(**r_it)) {
+      previous = NULL;
+      
+    } else if (previous != NULL &&
+               previous->getSelector() == (*r_it)->getSelector()) {
+
+#ifdef WITH_LIBGLOG
+      VLOG(2) << "Merging rulesets: " <<
+        (*r_it)->getSelector().toString();
+#endif
+      
+      for (d_it = (*r_it)->getDeclarations().begin();
+           d_it != (*r_it)->getDeclarations().end(); d_it++) {
+        previous->addSharedDeclaration(**d_it);
+      }
+      s.deleteRuleset(**r_it);
+      *r_it = NULL;
+      
+    } else
+      previous = *r_it;
+  }
+}
+
+void StylesheetOptimizer::removeOverridden(Ruleset &r) {
+  std::list<Declaration*> &declarations = r.getDeclarations();
+  std::list<Declaration*>::iterator d_it = declarations.end();
+  // A shared declaration can be in the ruleset more than once, so
+  // overridden declarations are marked by position.
+  std::vector<bool> overridden(declarations.size(), false);
+  size_t i = declarations.size(), count = 0;
+  // property -> 1 if overridden by a later value, 2 if overridden by
+  // a later !important value.
+  std::map<std::string, int> later;
+  std::map<std::string, int>::iterator l_it;
+  bool important;
+
+  while (d_it != declarations.begin()) {
+    d_it--;
+    i--;
+    
+    Token &property = (*d_it)->getProperty();
+    TokenList &value = (*d_it)->getValue();
+    important = isImportant(value);
+
+    l_it = later.find(property);
+    
+    if (l_it != later.end() &&
+        (l_it->second == 2 || !important) &&
+        !hasVendorPrefix(value)) {
+      overridden[i] = true;
+      count++;
+      
+    } else if (isPlainValue(value)) {
+      if (l_it == later.end())
+        later[property] = important ? 2 : 1;
+      else if (important)
+        l_it->second = 2;
+    }
+  }
+
+#ifdef WITH_LIBGLOG
+  VLOG(2) << "Removing " << count << " overridden declarations";
+#endif
+
+  if (count > 0)
+    r.deleteDeclarations(overridden);
+}
+
+bool StylesheetOptimizer::compactShorthands(Ruleset &r) {
+  size_t i;
+  bool changed = false;
+
+  // at-rules like @font-face have their own descriptors
+  if (r.getSelector().empty() ||
+      r.getSelector().front().type == Token::ATKEYWORD)
+    return false;
+  
+  for (i = 0; i < SHORTHAND_COUNT; i++) {
+    if (compactShorthand(r, SHORTHANDS[i]))
+      changed = true;
+  }
+  return changed;
+}
+
+bool StylesheetOptimizer::compactShorthand(Ruleset &r,
+                                           const Shorthand &shorthand) {
+  std::list<Declaration*> &declarations = r.getDeclarations();
+  std::list<Declaration*>::iterator d_it;
+  Declaration* longhands[8] = {NULL};
+  Declaration* last = NULL;
+  std::list<Declaration*>::iterator lastPosition;
+  std::vector<bool> positions(declarations.size(), false);
+  size_t position = 0, lastIndex = 0;
+  std::set<std::string> families, propertyFamilies;
+  size_t count = shorthand.box ? 4 : 8, i;
+  int important = -1;
+  bool blocked = false;
+  std::vector<TokenList> components, parts;
+  TokenList main, importantTokens, value;
+
+  getFamilies(shorthand.name, families);
+  for (i = 0; i < count; i++) 
+    getFamilies(shorthand.longhands[i], families);
+  
+  for (d_it = declarations.begin(); d_it != declarations.end();
+       d_it++, position++) {
+    Token &property = (*d_it)->getProperty();
+    
+    for (i = 0; i < count && property != shorthand.longhands[i]; i++) {
+    }
+    
+    if (i < count) {
+      // The longhands are only replaced if nothing related comes in
+      // between, and if they agree on !important.
+      if (longhands[i] != NULL || blocked ||
+          !isCompactable((*d_it)->getValue()))
+        return false;
+      if (important == -1)
+        important = isImportant((*d_it)->getValue());
+      else if (important != isImportant((*d_it)->getValue()))
+        return false;
+      
+      longhands[i] = last = *d_it;
+      lastPosition = d_it;
+      lastIndex = position;
+      positions[position] = true;
+      
+    } else if (last != NULL) {
+      propertyFamilies.clear();
+      getFamilies(property, propertyFamilies);
+      if (intersects(families, propertyFamilies))
+        blocked = true;
+    }
+  }
+
+  for (i = 0; i < count; i++) {
+    if (longhands[i] == NULL)
+      return false;
+  }
+
+  if (shorthand.box) {
+    for (i = 0; i < count; i++) {
+      main.clear();
+      importantTokens.clear();
+      splitImportant(longhands[i]->getValue(), main, importantTokens);
+      if (!splitValue(main, parts) || parts.size() != 1)
+        return false;
+      components.push_back(parts.front());
+    }
+    shortenBox(components);
+    joinValues(components, value);
+    
+  } else if (!getBackground(longhands, value))
+    return false;
+
+  if (important == 1) {
+    main.clear();
+    importantTokens.clear();
+    splitImportant(last->getValue(), main, importantTokens);
+    value.push_back(Token::BUILTIN_SPACE);
+    value.insert(value.end(), importantTokens.begin(),
+                 importantTokens.end());
+  }
+
+#ifdef WITH_LIBGLOG
+  VLOG(2) << "Compacting " << shorthand.name << ": " << value.toString();
+#endif
+
+  Token property(shorthand.name, Token::IDENTIFIER, 0, 0,
+                 Token::BUILTIN_SOURCE);
+  property.setLocation(last->getProperty());
+
+  // The last longhand is replaced with the shorthand.
+  positions[lastIndex] = false;
+  r.deleteDeclarations(positions);
+  
+  last = r.copyDeclaration(lastPosition);
+  last->setProperty(property);
+  last->setValue(value);
+  return true;
+}
+
+bool StylesheetOptimizer::getBackground(Declaration** longhands,
+                                        TokenList &value) {
+  std::vector<TokenList> components;
+  std::vector<TokenList> values;
+  TokenList main, important;
+  std::string position, size;
+  size_t i;
+
+  // color, image, repeat, attachment, position, size, origin, clip
+  for (i = 0; i < 8; i++) {
+    main.clear();
+    splitImportant(longhands[i]->getValue(), main, important);
+    // only single layer backgrounds
+    if (!splitValue(main, components))
+      return false;
+    values.push_back(main);
+  }
+  components.clear();
+  
+  if (values[1].toString() != "none")
+    components.push_back(values[1]);
+
+  position = values[4].toString();
+  size = values[5].toString();
+  if (size != "auto" && size != "auto auto") {
+    components.push_back(values[4]);
+    components.back().push_back(Token::BUILTIN_SPACE);
+    components.back().push_back(Token("/", Token::OTHER, 0, 0,
+                                      Token::BUILTIN_SOURCE));
+    components.back().push_back(Token::BUILTIN_SPACE);
+    components.back().insert(components.back().end(),
+                             values[5].begin(), values[5].end());
+  } else if (position != "0% 0%" && position != "0 0" &&
+             position != "left top")
+    components.push_back(values[4]);
+
+  if (values[2].toString() != "repeat")
+    components.push_back(values[2]);
+  if (values[3].toString() != "scroll")
+    components.push_back(values[3]);
+
+  // One box sets both the origin and the clip.
+  if (values[6] == values[7])
+    components.push_back(values[6]);
+  else if (values[6].toString() != "padding-box" ||
+           values[7].toString() != "border-box") {
+    components.push_back(values[6]);
+    components.push_back(values[7]);
+  }
+
+  if (values[0].toString() != "transparent")
+    components.push_back(values[0]);
+
+  if (components.empty()) {
+    value.push_back(Token("none", Token::IDENTIFIER, 0, 0,
+                          Token::BUILTIN_SOURCE));
+  } else
+    joinValues(components, value);
+  return true;
+}
+
+void StylesheetOptimizer::shortenBoxValues(Ruleset &r) {
+  std::list<Declaration*>::iterator d_it;
+  std::vector<TokenList> components;
+  TokenList main, important, value;
+  size_t i, count;
+
+  for (d_it = r.getDeclarations().begin();
+       d_it != r.getDeclarations().end(); d_it++) {
+    Token &property = (*d_it)->getProperty();
+    
+    for (i = 0; i < SHORTHAND_COUNT &&
+           (!SHORTHANDS[i].box || property != SHORTHANDS[i].name); i++) {
+    }
+    if (i == SHORTHAND_COUNT)
+      continue;
+
+    main.clear();
+    important.clear();
+    components.clear();
+    splitImportant((*d_it)->getValue(), main, important);
+    
+    if (!splitValue(main, components))
+      continue;
+    count = components.size();
+    shortenBox(components);
+    if (components.size() == count)
+      continue;
+
+    value.clear();
+    joinValues(components, value);
+    if (!important.empty()) {
+      value.push_back(Token::BUILTIN_SPACE);
+      value.insert(value.end(), important.begin(), important.end());
+    }
+    
+    // the declaration may be shared with other rulesets
+    r.copyDeclaration(d_it)->setValue(value);
+  }
+}
+
+void StylesheetOptimizer::groupDeclarations(Stylesheet &s,
+                                            std::vector<Ruleset*>
+                                            &rulesets) {
+  // declaration key -> index of the last ruleset with those
+  // declarations.
+  std::map<std::string, size_t> blocks;
+  std::map<std::string, size_t>::iterator b_it;
+  // property family -> index of the last ruleset that sets it.
+  std::map<std::string, size_t> families;
+  std::map<std::string, size_t>::iterator f_it;
+  std::set<std::string> rulesetFamilies;
+  std::set<std::string>::iterator rf_it;
+  std::list<Declaration*>::iterator d_it;
+  std::string key;
+  // one past the index of the last ruleset with declarations
+  size_t lastSet = 0;
+  size_t i, j;
+  Ruleset* r;
+  bool safe;
+
+  for (j = 0; j < rulesets.size(); j++) {
+    r = rulesets[j];
+
+    if (r == NULL) {
+      // Nothing can be moved past other statements.
+      blocks.clear();
+      continue;
+    }
+    
+    if (canMerge(*r)) {
+      key = getDeclarationKey(*r);
+      b_it = blocks.find(key);
+      
+      if (b_it != blocks.end()) {
+        i = b_it->second;
+        rulesetFamilies.clear();
+        getFamilies(*r, rulesetFamilies);
+
+        // The declarations are moved up to the earlier ruleset, which
+        // is only safe if no ruleset in between sets the same
+        // properties, or 'all'.
+        f_it = families.find(ALL_FAMILY);
+        safe = (f_it == families.end() || f_it->second <= i);
+        if (rulesetFamilies.find(ALL_FAMILY) != rulesetFamilies.end())
+          safe = safe && lastSet <= i + 1;
+        
+        for (rf_it = rulesetFamilies.begin();
+             safe && rf_it != rulesetFamilies.end(); rf_it++) {
+          f_it = families.find(*rf_it);
+          safe = (f_it == families.end() || f_it->second <= i);
+        }
+
+        if (safe) {
+          
+#ifdef WITH_LIBGLOG
+          VLOG(2) << "Grouping " << r->getSelector().toString() <<
+            " with " << rulesets[i]->getSelector().toString();
+#endif
+          
+          Selector &selector = rulesets[i]->getSelector();
+          selector.push_back(Token::BUILTIN_COMMA);
+          selector.insert(selector.end(), r->getSelector().begin(),
+                          r->getSelector().end());
+          s.deleteRuleset(*r);
+          rulesets[j] = NULL;
+          // the statement is gone so it does not block anything.
+          continue;
+        }
+      }
+      blocks[key] = j;
+    }
+    
+    rulesetFamilies.clear();
+    getFamilies(*r, rulesetFamilies);
+    for (rf_it = rulesetFamilies.begin(); rf_it != rulesetFamilies.end();
+         rf_it++) {
+      families[*rf_it] = j;
+    }
+    if (!rulesetFamilies.empty())
+      lastSet = j + 1;
+  }
+}
+
+std::string StylesheetOptimizer::getDeclarationKey(Ruleset &r) {
+  std::list<Declaration*>::iterator d_it;
+  std::string key;
+  
+  for (d_it = r.getDeclarations().begin();
+       d_it != r.getDeclarations().end(); d_it++) {
+    key.append((*d_it)->getProperty());
+    key.push_back(':');
+    key.append((*d_it)->getValue().toString());
+    key.push_back(';');
+  }
+  return key;
+}
+
+std::string StylesheetOptimizer::getFamily(const std::string &property) {
+  std::string name = getName(property);
+  size_t end;
+
+  if (name.compare(0, 2, "--") == 0)
+    return name;
+  
+  end = name.find('-');
+  if (end == std::string::npos)
+    return name;
+  return name.substr(0, end);
+}
+
+void StylesheetOptimizer::getFamilies(const std::string &property,
+                                      std::set<std::string> &families) {
+  static std::multimap<std::string, std::string>* longhands = NULL;
+  std::multimap<std::string, std::string>::iterator l_it, l_end;
+  std::string name = getName(property);
+  size_t i, j;
+
+  if (longhands == NULL) {
+    // shorthand -> families of its longhands
+    longhands = new std::multimap<std::string, std::string>();
+    for (i = 0; i < SHORTHAND_FAMILY_COUNT; i++) {
+      for (j = 0; j < 6 && SHORTHAND_FAMILIES[i].longhands[j] != NULL; j++) {
+        longhands->insert(std::pair<std::string, std::string>
+                          (SHORTHAND_FAMILIES[i].shorthand,
+                           getFamily(SHORTHAND_FAMILIES[i].longhands[j])));
+      }
+    }
+  }
+
+  families.insert(getFamily(property));
+
+  l_end = longhands->upper_bound(name);
+  for (l_it = longhands->lower_bound(name); l_it != l_end; l_it++)
+    families.insert(l_it->second);
+}
+
+std::string StylesheetOptimizer::getName(const std::string &property) {
+  size_t start = 0;
+
+  if (property.compare(0, 2, "--") == 0)
+    return property;
+  
+  // IE hacks
+  if (!property.empty() && (property[0] == '*' || property[0] == '_'))
+    start = 1;
+
+  // vendor prefix
+  if (property.size() > start && property[start] == '-') {
+    start = property.find('-', start + 1);
+    if (start == std::string::npos)
+      return property;
+    start++;
+  }
+  return property.substr(start);
+}
+
+bool StylesheetOptimizer::isImportant(const TokenList &value) {
+  TokenList::const_iterator i;
+  bool exclamation = false;
+
+  for (i = value.begin(); i != value.end(); i++) {
+    if (*i == "!")
+      exclamation = true;
+    else if (exclamation && (*i).type == Token::IDENTIFIER)
+      return (*i) == "important";
+  }
+  return false;
+}
+
+bool StylesheetOptimizer::hasVendorPrefix(const TokenList &tokens) {
+  TokenList::const_iterator i;
+
+  for (i = tokens.begin(); i != tokens.end(); i++) {
+    if ((*i).type == Token::IDENTIFIER &&
+        (*i).size() > 2 &&
+        (*i)[0] == '-' &&
+        (*i)[1] != '-' &&
+        (*i).find('-', 1) != std::string::npos)
+      return true;
+  }
+  return false;
+}
+
+bool StylesheetOptimizer::isCompactable(const TokenList &value) {
+  TokenList::const_iterator i;
+
+  for (i = value.begin(); i != value.end(); i++) {
+    if ((*i).find('\\') != std::string::npos ||
+        (*i) == "var" ||
+        (*i) == "inherit" ||
+        (*i) == "initial" ||
+        (*i) == "unset" ||
+        (*i) == "revert")
+      return false;
+  }
+  return !hasVendorPrefix(value);
+}
+
+void StylesheetOptimizer::splitImportant(const TokenList &value,
+                                         TokenList &main,
+                                         TokenList &important) {
+  TokenList::const_iterator i;
+
+  for (i = value.begin(); i != value.end() && *i != "!"; i++) {
+    main.push_back(*i);
+  }
+  important.insert(important.end(), i, value.end());
+  main.trim();
+}
+
+bool StylesheetOptimizer::splitValue(const TokenList &value,
+                                     std::vector<TokenList> &components) {
+  TokenList::const_iterator i;
+  int parentheses = 0;
+  
+  components.clear();
+  
+  for (i = value.begin(); i != value.end(); i++) {
+    if ((*i).type == Token::PAREN_OPEN)
+      parentheses++;
+    else if ((*i).type == Token::PAREN_CLOSED)
+      parentheses--;
+    else if (parentheses == 0) {
+      if (*i == "," || *i == "/")
+        return false;
+      if ((*i).type == Token::WHITESPACE) {
+        if (!components.empty() && !components.back().empty())
+          components.push_back(TokenList());
+        continue;
+      }
+    }
+    
+    if (components.empty())
+      components.push_back(TokenList());
+    components.back().push_back(*i);
+  }
+  if (!components.empty() && components.back().empty())
+    components.pop_back();
+  return true;
+}
+
+void StylesheetOptimizer::shortenBox(std::vector<TokenList> &components) {
+  // left == right
+  if (components.size() == 4 && components[3] == components[1])
+    components.pop_back();
+  // bottom == top
+  if (components.size() == 3 && components[2] == components[0])
+    components.pop_back();
+  // right == top
+  if (components.size() == 2 && components[1] == components[0])
+    components.pop_back();
+}
+
+void StylesheetOptimizer::joinValues(const std::vector<TokenList>
+                                     &components, TokenList &value) {
+  std::vector<TokenList>::const_iterator i;
+
+  for (i = components.begin(); i != components.end(); i++) {
+    if (i != components.begin())
+      value.push_back(Token::BUILTIN_SPACE);
+    value.insert(value.end(), (*i).begin(), (*i).end());
+  }
+}
+
+bool StylesheetOptimizer::isPlainValue(const TokenList &value) {
+  TokenList::const_iterator i;
+
+  for (i = value.begin(); i != value.end(); i++) {
+    if ((*i).type == Token::PAREN_OPEN ||
+        (*i).find('\\') != std::string::npos)
+      return false;
+  }
+  return !hasVendorPrefix(value);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __StylesheetOptimizer_h__
+#define __StylesheetOptimizer_h__
+
+#include "Stylesheet.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+struct Shorthand;
+
+/**
+ * Makes the output smaller without changing what it does: adjacent
+ * rulesets with the same selector are merged, declarations that are
+ * overridden later in the same ruleset are removed, complete sets of
+ * longhands are replaced with their shorthand and rulesets with the
+ * same declarations are grouped into one selector list.
+ */
+class StylesheetOptimizer {
+private:
+  /**
+   * The rulesets of the stylesheet in statement order. Other
+   * statements are NULL.
+   */
+  void getRulesets(Stylesheet &s, std::vector<Ruleset*> &rulesets);
+  bool canMerge(Ruleset &r);
+  /**
+   * Comments and at-rules that do not hold style rules, like
+   * @font-face, don't change which rule wins when rules are moved
+   * past them. Other statements, like @supports blocks or inlined
+   * css, might.
+   */
+  bool canMovePast(StylesheetStatement &statement);
+
+  void mergeSelectors(Stylesheet &s, std::vector<Ruleset*> &rulesets);
+  void removeOverridden(Ruleset &r);
+  bool compactShorthands(Ruleset &r);
+  bool compactShorthand(Ruleset &r, const Shorthand &shorthand);
+  /**
+   * Remove repeated values from box shorthands, for example
+   * 'margin: 0 auto 0 auto' becomes 'margin: 0 auto'.
+   */
+  void shortenBoxValues(Ruleset &r);
+  void groupDeclarations(Stylesheet &s, std::vector<Ruleset*> &rulesets);
+
+  std::string getDeclarationKey(Ruleset &r);
+
+  void getMediaQueries(Stylesheet &s, std::vector<MediaQuery*> &queries);
+  void getFamilies(Ruleset &r, std::set<std::string> &families);
+  /**
+   * Declarations can only change places if their families do not
+   * intersect. A set with 'all' intersects with every other set that
+   * is not empty.
+   */
+  bool intersects(const std::set<std::string> &a,
+                  const std::set<std::string> &b);
+
+  bool getBackground(Declaration** longhands, TokenList &value);
+
+protected:
+  /**
+   * The property without IE hack or vendor prefix.
+   */
+  std::string getName(const std::string &property);
+  /**
+   * The name of the property up to the first '-', so shorthands and
+   * their longhands share a family.
+   */
+  std::string getFamily(const std::string &property);
+  /**
+   * Add the family of the property and, if it is one of the
+   * shorthands in SHORTHAND_FAMILIES, the families of its longhands.
+   */
+  void getFamilies(const std::string &property,
+                   std::set<std::string> &families);
+  bool isImportant(const TokenList &value);
+  bool hasVendorPrefix(const TokenList &tokens);
+  /**
+   * Values without functions, vendor prefixes or hacks are understood
+   * by every browser, so they can replace an earlier value.
+   */
+  bool isPlainValue(const TokenList &value);
+  /**
+   * Values that can be combined into a shorthand: no hacks, vendor
+   * prefixes, variables or keywords like 'inherit'.
+   */
+  bool isCompactable(const TokenList &value);
+
+  /**
+   * Moves '!important' from the end of value to important.
+   */
+  void splitImportant(const TokenList &value, TokenList &main,
+                      TokenList &important);
+  /**
+   * Split a value on whitespace. Returns false if the value has more
+   * than one layer or a '/'.
+   */
+  bool splitValue(const TokenList &value,
+                  std::vector<TokenList> &components);
+  void shortenBox(std::vector<TokenList> &components);
+  void joinValues(const std::vector<TokenList> &components,
+                  TokenList &value);
+  
+public:
+  StylesheetOptimizer();
+  virtual ~StylesheetOptimizer();
+  
+  virtual void optimize(Stylesheet &s);
+
+  /**
+   * Move the rules of media queries into the last media query with
+   * the same query. A media query is left where it is, with a
+   * warning, if a statement it would be moved past sets the same
+   * properties, since that would change which rule wins.
+   */
+  virtual void mergeMediaQueries(Stylesheet &s);
+};
+
+#endif
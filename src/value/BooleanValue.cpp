@@ -8,6 +8,7 @@ BooleanValue::BooleanValue(bool value) {
 }
 BooleanValue::BooleanValue(const Token &t, bool value) {
   tokens.push_back(t);
+  setLocation(t);
   setValue(value);
   type = Value::BOOLEAN;
 }
@@ -20,7 +21,11 @@ bool BooleanValue::getValue() const {
 }
 void BooleanValue::setValue(bool value) {
   this->value = value;
-  tokens.front() = value ? "true" : "false";
+  setModified();
+}
+
+void BooleanValue::updateTokens() const {
+  tokens.front().assign(value ? "true" : "false");
 }
 
 Value* BooleanValue::add(const Value &v) const {
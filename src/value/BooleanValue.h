@@ -32,6 +32,10 @@
 class BooleanValue: public Value {
 private:
   bool value;
+
+protected:
+  virtual void updateTokens() const;
+  
 public:
   BooleanValue(bool value);
   BooleanValue(const Token &t, bool value);
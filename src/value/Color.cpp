@@ -27,20 +27,29 @@
 #include <glog/logging.h>
 #endif
 
-#include <sstream>
-#include <iostream>
-
 #define max(x,y) x > y ? x : y
 #define min(x,y) x < y ? x : y
 
-
-template <class T>
-inline std::string to_string (const T& t)
-{
-  std::stringstream ss;
-  ss << t;
-  return ss.str();
-}
+const signed char Color::HEX_VALUES[256] = {
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+   0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+const char Color::HEX_DIGITS[17] = "0123456789abcdef";
 
 double Color::maxArray(double* array, const size_t len) const {
   double ret = array[0];
@@ -55,11 +64,12 @@ double Color::minArray(double* array, const size_t len) const {
   return ret;
 }
 
-void Color::updateTokens() {
-  ostringstream stm;
-  string sColor[3];
-  string hash;
+void Color::updateTokens() const {
+  char buffer[32];
+  size_t length;
+  unsigned int c;
   int i;
+  const char* name;
 
   tokens.clear();
 
@@ -67,56 +77,62 @@ void Color::updateTokens() {
   VLOG(3) << "Update tokens";
 #endif
 
-  // If the color is not opaque the rgba() function needs to be used.
-  if (alpha < 1) {
+  if (alpha == 0 && color[RGB_RED] == 0 && color[RGB_GREEN] == 0 &&
+      color[RGB_BLUE] == 0) {
+    tokens.push_back(Token("transparent", Token::IDENTIFIER, 0, 0,
+                           "generated"));
+    
+    // If the color is not opaque the rgba() function needs to be used.
+  } else if (alpha < 1) {
     tokens.push_back(Token("rgba", Token::IDENTIFIER, 0, 0, "generated"));
     tokens.push_back(Token::BUILTIN_PAREN_OPEN);
 
     for (i = 0; i < 3; i++) {
-      stm.str("");
-      stm << (color[i] & 0xFF);
-      tokens.push_back(Token(stm.str(), Token::NUMBER, 0, 0, "generated"));
+      c = color[i];
+      length = 0;
+      if (c >= 100)
+        buffer[length++] = '0' + c / 100;
+      if (c >= 10)
+        buffer[length++] = '0' + (c / 10) % 10;
+      buffer[length++] = '0' + c % 10;
+      
+      tokens.push_back(Token(std::string(buffer, length),
+                             Token::NUMBER, 0, 0, "generated"));
       tokens.push_back(Token::BUILTIN_COMMA);
     }
-    stm.str("");
-    stm << alpha;
-    tokens.push_back(Token(stm.str(), Token::NUMBER, 0, 0, "generated"));
+    length = NumberValue::formatNumber(alpha, 6, buffer, sizeof(buffer));
+    tokens.push_back(Token(std::string(buffer, length),
+                           Token::NUMBER, 0, 0, "generated"));
     tokens.push_back(Token::BUILTIN_PAREN_CLOSED);
 
+  } else if ((name = ColorNames::getShortName(color[RGB_RED],
+                                             color[RGB_GREEN],
+                                             color[RGB_BLUE])) != NULL) {
+    tokens.push_back(Token(name, Token::IDENTIFIER, 0, 0, "generated"));
+    
   } else {
-  
-    for (i = 0; i < 3; i++) {
-      stm.str("");
-      stm << hex << (color[i] & 0xFF);
-      sColor[i] = stm.str();
-    }
-    stm.str("");
-    stm << "#";
-  
+    buffer[0] = '#';
     for (i = 0; i < 3; i++) {
-      if (sColor[i].size() == 1)
-        stm << "0";
-      else if (sColor[i].size() > 2) 
-        sColor[i] = sColor[i].substr(0, 2);
-      stm << sColor[i];
+      buffer[1 + i * 2] = HEX_DIGITS[color[i] >> 4];
+      buffer[2 + i * 2] = HEX_DIGITS[color[i] & 0xF];
     }
-    hash = stm.str();
-
+    length = 7;
+    
     // convert to shorthand if possible
-    if (hash[1] == hash[2] &&
-        hash[3] == hash[4] &&
-        hash[5] == hash[6]) {
-      stm.str("");
-      stm << "#" << hash[1] << hash[3] << hash[5];
-      hash = stm.str();
+    if (buffer[1] == buffer[2] &&
+        buffer[3] == buffer[4] &&
+        buffer[5] == buffer[6]) {
+      buffer[2] = buffer[3];
+      buffer[3] = buffer[5];
+      length = 4;
     }
 
-    tokens.push_back(Token(hash, Token::HASH, 0,0,"generated"));
+    tokens.push_back(Token(std::string(buffer, length),
+                           Token::HASH, 0, 0, "generated"));
   }
 #ifdef WITH_LIBGLOG
   VLOG(3) << tokens.toString();
 #endif
-
 }
 
 Color::Color(): Value() {
@@ -125,13 +141,14 @@ Color::Color(): Value() {
   color[RGB_GREEN] = 0;
   color[RGB_BLUE] = 0;
   alpha = 1.0;
-  updateTokens();
+  setModified();
 }
 
 Color::Color(Token &token): Value() {
-  int len;
+  int len, high, low;
 
   this->tokens.push_back(token);
+  setLocation(token);
     
   type = Value::COLOR;
   
@@ -145,20 +162,44 @@ Color::Color(Token &token): Value() {
   }
   
   for (int i = 0; i < 3; i++) {
-    istringstream stm(token.substr(1 + (i * len), len));
-    stm >> hex >> color[i];
-    if (len == 1)
-      color[i] = color[i] * 0x11;
+    high = HEX_VALUES[(unsigned char)token[1 + i * len]];
+    low = HEX_VALUES[(unsigned char)token[i * len + len]];
+    
+    if (high < 0 || low < 0) {
+      throw new ValueException("A color value requires either three "
+                               "or six hexadecimal characters.",
+                               *this->getTokens());
+    }
+    color[i] = (high << 4) | low;
   }
   alpha = 1;
 }
+Color::Color(Token &token, const ColorNames::ColorName &name): Value() {
+  this->tokens.push_back(token);
+  setLocation(token);
+
+  type = Value::COLOR;
+  color[RGB_RED] = name.red;
+  color[RGB_GREEN] = name.green;
+  color[RGB_BLUE] = name.blue;
+  alpha = name.alpha / 255.0;
+}
+
+Color* Color::fromName(Token &token) {
+  const ColorNames::ColorName* name = ColorNames::find(token);
+
+  if (name == NULL)
+    return NULL;
+  return new Color(token, *name);
+}
+
 Color::Color(unsigned int red, unsigned int green, unsigned int blue): Value() {
   type = Value::COLOR;
   color[RGB_RED] = red;
   color[RGB_GREEN] = green;
   color[RGB_BLUE] = blue;
   alpha = 1;
-  updateTokens();
+  setModified();
 }
 Color::Color(unsigned int red, unsigned int green, unsigned int blue,
              double alpha): Value() { 
@@ -167,7 +208,7 @@ Color::Color(unsigned int red, unsigned int green, unsigned int blue,
   color[RGB_GREEN] = green;
   color[RGB_BLUE] = blue;
   this->alpha = alpha;
-  updateTokens();
+  setModified();
 }
 
 Color* Color::fromHSL(double hue, double saturation, double lightness) {
@@ -221,13 +262,22 @@ Color* Color::fromHSL(double hue, double saturation, double lightness) {
                    rgb[RGB_BLUE] * 255 + 0.5);
 }
 
-Color::Color(const Color &color) {
+Color::Color(const Color &color): Value() {
   type = Value::COLOR;
   this->color[RGB_RED] = color.getRed();
   this->color[RGB_GREEN] = color.getGreen();
   this->color[RGB_BLUE] = color.getBlue();
   alpha = color.getAlpha();
-  updateTokens();
+  setModified();
+}
+
+Color& Color::operator=(const Color &color) {
+  this->color[RGB_RED] = color.getRed();
+  this->color[RGB_GREEN] = color.getGreen();
+  this->color[RGB_BLUE] = color.getBlue();
+  alpha = color.getAlpha();
+  setModified();
+  return *this;
 }
 
 Color::~Color() {
@@ -375,11 +425,11 @@ void Color::setRGB(unsigned int red, unsigned int green, unsigned int blue) {
   color[RGB_RED] = red;
   color[RGB_GREEN] = green;
   color[RGB_BLUE] = blue;
-  updateTokens();
+  setModified();
 }
 void Color::setAlpha(double alpha) {
   this->alpha = min(max(alpha, 0.0), 1.0);
-  updateTokens();
+  setModified();
 }
 double Color::getAlpha() const {
   return alpha;
@@ -565,10 +615,8 @@ Value* Color::lightness(const vector<const Value*> &arguments) {
 
 Value* Color::argb(const vector<const Value*> &arguments) {
   const Color* c = (const Color*)arguments[0];
-  ostringstream stm;
-  unsigned int color[4];
-  string sColor[4];
-  string hash;
+  unsigned char color[4];
+  char hash[9];
   int i;
   Token t;
 
@@ -576,24 +624,13 @@ Value* Color::argb(const vector<const Value*> &arguments) {
   color[1] = c->getRed();
   color[2] = c->getGreen();
   color[3] = c->getBlue();
-  
-  for (i = 0; i < 4; i++) {
-    stm.str("");
-    stm << hex << (color[i] & 0xFF);
-    sColor[i] = stm.str();
-  }
-  stm.str("");
-  stm << "#";
-  
+
+  hash[0] = '#';
   for (i = 0; i < 4; i++) {
-    if (sColor[i].size() == 1)
-      stm << "0";
-    else if (sColor[i].size() > 2) 
-      sColor[i] = sColor[i].substr(0, 2);
-    stm << sColor[i];
+    hash[1 + i * 2] = HEX_DIGITS[color[i] >> 4];
+    hash[2 + i * 2] = HEX_DIGITS[color[i] & 0xF];
   }
-  hash = stm.str();
-  t = Token(hash, Token::STRING, 0,0,"generated");
+  t = Token(std::string(hash, 9), Token::STRING, 0,0,"generated");
   return new StringValue(t, false);
 }
 
@@ -26,6 +26,7 @@
 #include "NumberValue.h"
 #include "StringValue.h"
 #include "FunctionLibrary.h"
+#include "ColorNames.h"
 #include <algorithm>
 #include <cmath>
 using namespace std;
@@ -37,13 +38,24 @@ using namespace std;
 
 class Color: public Value {
 private:
-  unsigned int color[3];
+  unsigned char color[3];
   double alpha;
+
+  /**
+   * The value of each hexadecimal digit by character, or -1.
+   */
+  static const signed char HEX_VALUES[256];
+  static const char HEX_DIGITS[17];
   
   double maxArray(double* array, const size_t len) const;
   double minArray(double* array, const size_t len) const;
 
-  void updateTokens();
+protected:
+  /**
+   * Colors that were parsed and have not been changed keep the token
+   * they were parsed from.
+   */
+  virtual void updateTokens() const;
   
 public:
   Color();
@@ -52,6 +64,18 @@ public:
   Color(unsigned int red, unsigned int green, unsigned int blue,
         double alpha);
   Color(const Color &color);
+  Color& operator=(const Color &color);
+  /**
+   * A color parsed from a color name like 'red'.
+   */
+  Color(Token &token, const ColorNames::ColorName &name);
+
+  /**
+   * Create a color from an identifier if it is a color name.
+   *
+   * @return the color or NULL if the identifier is not a color name.
+   */
+  static Color* fromName(Token &token);
 
   /**
    * The HSL to RGB conversion on
@@ -0,0 +1,379 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "ColorNames.h"
+
+#include <cstddef>
+#include <strings.h>
+
+/*
+ * The seeds are found by placing the largest buckets first and trying
+ * seeds until every name in the bucket lands in a free slot.
+ */
+const unsigned short ColorNames::SEEDS[SEED_COUNT] = {
+  0, 0, 0, 6, 1, 2, 1, 0, 2, 1, 2, 0,
+  2, 1, 2, 2, 4, 1, 3, 2, 2, 3, 1, 2,
+  4, 2, 1, 0, 2, 1, 1, 3, 3, 0, 1, 0,
+  4, 0, 1, 2, 1, 2, 1, 1, 1, 5, 1, 1,
+  5, 3, 5, 3, 8, 1, 1, 3, 0, 5, 1, 1,
+  1, 5, 1, 14
+};
+
+const ColorNames::ColorName ColorNames::NAMES[NAME_COUNT] = {
+  {"mediumpurple", 147, 112, 219, 255},
+  {"aquamarine", 127, 255, 212, 255},
+  {NULL, 0, 0, 0, 0},
+  {"darkgrey", 169, 169, 169, 255},
+  {"whitesmoke", 245, 245, 245, 255},
+  {"lightgoldenrodyellow", 250, 250, 210, 255},
+  {"lightcoral", 240, 128, 128, 255},
+  {NULL, 0, 0, 0, 0},
+  {"linen", 250, 240, 230, 255},
+  {"mediumturquoise", 72, 209, 204, 255},
+  {"goldenrod", 218, 165, 32, 255},
+  {"coral", 255, 127, 80, 255},
+  {NULL, 0, 0, 0, 0},
+  {"fuchsia", 255, 0, 255, 255},
+  {"thistle", 216, 191, 216, 255},
+  {NULL, 0, 0, 0, 0},
+  {"darkseagreen", 143, 188, 143, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"lightsteelblue", 176, 196, 222, 255},
+  {"darkblue", 0, 0, 139, 255},
+  {NULL, 0, 0, 0, 0},
+  {"darkred", 139, 0, 0, 255},
+  {NULL, 0, 0, 0, 0},
+  {"blueviolet", 138, 43, 226, 255},
+  {"purple", 128, 0, 128, 255},
+  {NULL, 0, 0, 0, 0},
+  {"lightsalmon", 255, 160, 122, 255},
+  {"wheat", 245, 222, 179, 255},
+  {"lime", 0, 255, 0, 255},
+  {"palevioletred", 219, 112, 147, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"lemonchiffon", 255, 250, 205, 255},
+  {"khaki", 240, 230, 140, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"slategray", 112, 128, 144, 255},
+  {"darkturquoise", 0, 206, 209, 255},
+  {NULL, 0, 0, 0, 0},
+  {"greenyellow", 173, 255, 47, 255},
+  {"darksalmon", 233, 150, 122, 255},
+  {"dimgrey", 105, 105, 105, 255},
+  {NULL, 0, 0, 0, 0},
+  {"chocolate", 210, 105, 30, 255},
+  {NULL, 0, 0, 0, 0},
+  {"rosybrown", 188, 143, 143, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"firebrick", 178, 34, 34, 255},
+  {"olivedrab", 107, 142, 35, 255},
+  {"dodgerblue", 30, 144, 255, 255},
+  {NULL, 0, 0, 0, 0},
+  {"saddlebrown", 139, 69, 19, 255},
+  {"olive", 128, 128, 0, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"mediumaquamarine", 102, 205, 170, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"skyblue", 135, 206, 235, 255},
+  {"lightskyblue", 135, 206, 250, 255},
+  {"indianred", 205, 92, 92, 255},
+  {"palegoldenrod", 238, 232, 170, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"mediumseagreen", 60, 179, 113, 255},
+  {"bisque", 255, 228, 196, 255},
+  {NULL, 0, 0, 0, 0},
+  {"white", 255, 255, 255, 255},
+  {NULL, 0, 0, 0, 0},
+  {"lavender", 230, 230, 250, 255},
+  {NULL, 0, 0, 0, 0},
+  {"turquoise", 64, 224, 208, 255},
+  {"plum", 221, 160, 221, 255},
+  {"sandybrown", 244, 164, 96, 255},
+  {"ghostwhite", 248, 248, 255, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"slategrey", 112, 128, 144, 255},
+  {"teal", 0, 128, 128, 255},
+  {NULL, 0, 0, 0, 0},
+  {"lightcyan", 224, 255, 255, 255},
+  {"grey", 128, 128, 128, 255},
+  {"lightyellow", 255, 255, 224, 255},
+  {NULL, 0, 0, 0, 0},
+  {"yellowgreen", 154, 205, 50, 255},
+  {"violet", 238, 130, 238, 255},
+  {"paleturquoise", 175, 238, 238, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"rebeccapurple", 102, 51, 153, 255},
+  {"navy", 0, 0, 128, 255},
+  {"springgreen", 0, 255, 127, 255},
+  {NULL, 0, 0, 0, 0},
+  {"gray", 128, 128, 128, 255},
+  {"pink", 255, 192, 203, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"ivory", 255, 255, 240, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"mediumblue", 0, 0, 205, 255},
+  {NULL, 0, 0, 0, 0},
+  {"cornflowerblue", 100, 149, 237, 255},
+  {"seashell", 255, 245, 238, 255},
+  {NULL, 0, 0, 0, 0},
+  {"moccasin", 255, 228, 181, 255},
+  {"blanchedalmond", 255, 235, 205, 255},
+  {"magenta", 255, 0, 255, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"deeppink", 255, 20, 147, 255},
+  {"slateblue", 106, 90, 205, 255},
+  {"beige", 245, 245, 220, 255},
+  {"darkorchid", 153, 50, 204, 255},
+  {"hotpink", 255, 105, 180, 255},
+  {"gold", 255, 215, 0, 255},
+  {"palegreen", 152, 251, 152, 255},
+  {NULL, 0, 0, 0, 0},
+  {"blue", 0, 0, 255, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"darkolivegreen", 85, 107, 47, 255},
+  {NULL, 0, 0, 0, 0},
+  {"lightpink", 255, 182, 193, 255},
+  {"darkcyan", 0, 139, 139, 255},
+  {"brown", 165, 42, 42, 255},
+  {"azure", 240, 255, 255, 255},
+  {"mistyrose", 255, 228, 225, 255},
+  {NULL, 0, 0, 0, 0},
+  {"darkslategray", 47, 79, 79, 255},
+  {"orangered", 255, 69, 0, 255},
+  {NULL, 0, 0, 0, 0},
+  {"darkviolet", 148, 0, 211, 255},
+  {"gainsboro", 220, 220, 220, 255},
+  {NULL, 0, 0, 0, 0},
+  {"indigo", 75, 0, 130, 255},
+  {"darkgreen", 0, 100, 0, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"black", 0, 0, 0, 255},
+  {"crimson", 220, 20, 60, 255},
+  {"peachpuff", 255, 218, 185, 255},
+  {"royalblue", 65, 105, 225, 255},
+  {"seagreen", 46, 139, 87, 255},
+  {"mediumspringgreen", 0, 250, 154, 255},
+  {"steelblue", 70, 130, 180, 255},
+  {"papayawhip", 255, 239, 213, 255},
+  {"transparent", 0, 0, 0, 0},
+  {"cadetblue", 95, 158, 160, 255},
+  {NULL, 0, 0, 0, 0},
+  {"cornsilk", 255, 248, 220, 255},
+  {"mintcream", 245, 255, 250, 255},
+  {"mediumslateblue", 123, 104, 238, 255},
+  {"red", 255, 0, 0, 255},
+  {"burlywood", 222, 184, 135, 255},
+  {"mediumorchid", 186, 85, 211, 255},
+  {"navajowhite", 255, 222, 173, 255},
+  {"darkorange", 255, 140, 0, 255},
+  {NULL, 0, 0, 0, 0},
+  {"midnightblue", 25, 25, 112, 255},
+  {NULL, 0, 0, 0, 0},
+  {"lavenderblush", 255, 240, 245, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"lightslategray", 119, 136, 153, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"orange", 255, 165, 0, 255},
+  {"darkmagenta", 139, 0, 139, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"darkslategrey", 47, 79, 79, 255},
+  {"yellow", 255, 255, 0, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"antiquewhite", 250, 235, 215, 255},
+  {"oldlace", 253, 245, 230, 255},
+  {NULL, 0, 0, 0, 0},
+  {"chartreuse", 127, 255, 0, 255},
+  {"darkslateblue", 72, 61, 139, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"lightslategrey", 119, 136, 153, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"cyan", 0, 255, 255, 255},
+  {"honeydew", 240, 255, 240, 255},
+  {"peru", 205, 133, 63, 255},
+  {"darkkhaki", 189, 183, 107, 255},
+  {"lightgray", 211, 211, 211, 255},
+  {"salmon", 250, 128, 114, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"mediumvioletred", 199, 21, 133, 255},
+  {"floralwhite", 255, 250, 240, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"lightseagreen", 32, 178, 170, 255},
+  {"tomato", 255, 99, 71, 255},
+  {NULL, 0, 0, 0, 0},
+  {"deepskyblue", 0, 191, 255, 255},
+  {NULL, 0, 0, 0, 0},
+  {"powderblue", 176, 224, 230, 255},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {NULL, 0, 0, 0, 0},
+  {"lawngreen", 124, 252, 0, 255},
+  {NULL, 0, 0, 0, 0},
+  {"snow", 255, 250, 250, 255},
+  {"tan", 210, 180, 140, 255},
+  {"aliceblue", 240, 248, 255, 255},
+  {"sienna", 160, 82, 45, 255},
+  {"green", 0, 128, 0, 255},
+  {NULL, 0, 0, 0, 0},
+  {"dimgray", 105, 105, 105, 255},
+  {"lightgrey", 211, 211, 211, 255},
+  {"silver", 192, 192, 192, 255},
+  {"lightblue", 173, 216, 230, 255},
+  {"forestgreen", 34, 139, 34, 255},
+  {"darkgoldenrod", 184, 134, 11, 255},
+  {"darkgray", 169, 169, 169, 255},
+  {NULL, 0, 0, 0, 0},
+  {"limegreen", 50, 205, 50, 255},
+  {NULL, 0, 0, 0, 0},
+  {"lightgreen", 144, 238, 144, 255},
+  {"maroon", 128, 0, 0, 255},
+  {NULL, 0, 0, 0, 0},
+  {"aqua", 0, 255, 255, 255},
+  {"orchid", 218, 112, 214, 255}
+};
+
+const ColorNames::ShortName ColorNames::SHORT_NAMES[] = {
+  {0x000080, "navy"},
+  {0x008000, "green"},
+  {0x008080, "teal"},
+  {0x4b0082, "indigo"},
+  {0x800000, "maroon"},
+  {0x800080, "purple"},
+  {0x808000, "olive"},
+  {0x808080, "gray"},
+  {0xa0522d, "sienna"},
+  {0xa52a2a, "brown"},
+  {0xc0c0c0, "silver"},
+  {0xcd853f, "peru"},
+  {0xd2b48c, "tan"},
+  {0xda70d6, "orchid"},
+  {0xdda0dd, "plum"},
+  {0xee82ee, "violet"},
+  {0xf0e68c, "khaki"},
+  {0xf0ffff, "azure"},
+  {0xf5deb3, "wheat"},
+  {0xf5f5dc, "beige"},
+  {0xfa8072, "salmon"},
+  {0xfaf0e6, "linen"},
+  {0xff0000, "red"},
+  {0xff6347, "tomato"},
+  {0xff7f50, "coral"},
+  {0xffa500, "orange"},
+  {0xffc0cb, "pink"},
+  {0xffd700, "gold"},
+  {0xffe4c4, "bisque"},
+  {0xfffafa, "snow"},
+  {0xfffff0, "ivory"}
+};
+
+const size_t ColorNames::SHORT_NAME_COUNT =
+  sizeof(ColorNames::SHORT_NAMES) / sizeof(ColorNames::SHORT_NAMES[0]);
+
+unsigned int ColorNames::hash(const std::string &str, unsigned int seed) {
+  std::string::const_iterator i;
+  unsigned int h = 2166136261u ^ seed;
+
+  for (i = str.begin(); i != str.end(); i++) {
+    h ^= (unsigned char)*i | 0x20;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+const ColorNames::ColorName* ColorNames::find(const std::string &name) {
+  const ColorName* color;
+
+  // "red" to "lightgoldenrodyellow"
+  if (name.size() < 3 || name.size() > 20)
+    return NULL;
+
+  color = &NAMES[hash(name, SEEDS[hash(name, 0) % SEED_COUNT]) %
+                 NAME_COUNT];
+  
+  if (color->name != NULL &&
+      strcasecmp(color->name, name.c_str()) == 0)
+    return color;
+  return NULL;
+}
+
+const char* ColorNames::getShortName(unsigned char red,
+                                     unsigned char green,
+                                     unsigned char blue) {
+  unsigned int rgb = (red << 16) | (green << 8) | blue;
+  size_t low = 0, high = SHORT_NAME_COUNT, middle;
+
+  while (low < high) {
+    middle = (low + high) / 2;
+    if (SHORT_NAMES[middle].rgb < rgb)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  if (low < SHORT_NAME_COUNT && SHORT_NAMES[low].rgb == rgb)
+    return SHORT_NAMES[low].name;
+  return NULL;
+}
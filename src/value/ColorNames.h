@@ -0,0 +1,85 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __ColorNames_h__
+#define __ColorNames_h__
+
+#include <string>
+
+/**
+ * The CSS named colors. Names are found with a perfect hash so an
+ * identifier can be checked with two hashes and one compare.
+ */
+class ColorNames {
+public:
+  struct ColorName {
+    const char* name;
+    unsigned char red, green, blue;
+    /**
+     * 255, or 0 for transparent.
+     */
+    unsigned char alpha;
+  };
+
+  /**
+   * Find a named color. Names are case insensitive.
+   *
+   * @return the color or NULL if name is not a color name.
+   */
+  static const ColorName* find(const std::string &name);
+
+  /**
+   * Get a color name that is shorter than the hexadecimal notation
+   * of the color.
+   *
+   * @return the name or NULL if there is no such name.
+   */
+  static const char* getShortName(unsigned char red, unsigned char green,
+                                  unsigned char blue);
+
+private:
+  struct ShortName {
+    unsigned int rgb;
+    const char* name;
+  };
+
+  /**
+   * The names are spread over SEED_COUNT buckets, each with a seed
+   * that puts the names in the bucket in their own slot of NAMES.
+   */
+  static const size_t SEED_COUNT = 64;
+  static const size_t NAME_COUNT = 256;
+  
+  static const unsigned short SEEDS[SEED_COUNT];
+  static const ColorName NAMES[NAME_COUNT];
+  /**
+   * Sorted by rgb value.
+   */
+  static const ShortName SHORT_NAMES[];
+  static const size_t SHORT_NAME_COUNT;
+
+  /**
+   * FNV-1a over the lower case characters of str.
+   */
+  static unsigned int hash(const std::string &str, unsigned int seed);
+};
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "DataUri.h"
+
+#include <config.h>
+
+#ifdef WITH_LIBGLOG
+#include <glog/logging.h>
+#endif
+
+#include <fstream>
+#include <cstring>
+#include <cctype>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+char DataUri::table[4096 * 2];
+
+DataUri::DataUri() {
+  maxSize = DEFAULT_MAX_SIZE;
+}
+
+DataUri& DataUri::getInstance() {
+  static DataUri datauri;
+  return datauri;
+}
+
+void DataUri::setMaxSize(size_t size) {
+  maxSize = size;
+}
+
+size_t DataUri::getMaxSize() const {
+  return maxSize;
+}
+
+void DataUri::initTable() {
+  static const char* chars =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  unsigned int i;
+
+  for (i = 0; i < 4096; i++) {
+    table[i * 2] = chars[i >> 6];
+    table[i * 2 + 1] = chars[i & 0x3F];
+  }
+}
+
+void DataUri::base64(const unsigned char* data, size_t length,
+                     std::string &out) {
+  static bool initialized = false;
+  size_t pos = out.size();
+  size_t i;
+  unsigned int bits;
+  char* dst;
+
+  if (!initialized) {
+    initTable();
+    initialized = true;
+  }
+  
+  out.resize(pos + (length + 2) / 3 * 4);
+  dst = &out[pos];
+
+  for (i = 0; i + 3 <= length; i += 3) {
+    bits = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+    memcpy(dst, table + (bits >> 12) * 2, 2);
+    memcpy(dst + 2, table + (bits & 0xFFF) * 2, 2);
+    dst += 4;
+  }
+
+  if (i < length) {
+    bits = data[i] << 16;
+    if (i + 1 < length)
+      bits |= data[i + 1] << 8;
+    
+    memcpy(dst, table + (bits >> 12) * 2, 2);
+    memcpy(dst + 2, table + (bits & 0xFFF) * 2, 2);
+    dst[3] = '=';
+    if (i + 1 == length)
+      dst[2] = '=';
+  }
+}
+
+void DataUri::urlEncode(const std::string &data, std::string &out) {
+  static const char* hex = "0123456789ABCDEF";
+  std::string::const_iterator i;
+  unsigned char c;
+
+  // the characters encodeURIComponent() leaves alone
+  for (i = data.begin(); i != data.end(); i++) {
+    c = *i;
+    if (isalnum(c) || strchr("-_.!~*'()", c) != NULL) {
+      out.push_back(c);
+    } else {
+      out.push_back('%');
+      out.push_back(hex[c >> 4]);
+      out.push_back(hex[c & 0xF]);
+    }
+  }
+}
+
+std::string DataUri::sniffMimeType(const std::string &data,
+                                   const std::string &path) {
+  size_t pos;
+  std::string extension;
+  
+  if (data.compare(0, 8, "\x89PNG\r\n\x1a\n") == 0)
+    return "image/png";
+  else if (data.compare(0, 3, "\xff\xd8\xff") == 0)
+    return "image/jpeg";
+  else if (data.compare(0, 6, "GIF87a") == 0 ||
+           data.compare(0, 6, "GIF89a") == 0)
+    return "image/gif";
+  else if (data.size() >= 12 &&
+           data.compare(0, 4, "RIFF") == 0 &&
+           data.compare(8, 4, "WEBP") == 0)
+    return "image/webp";
+  else if (data.compare(0, 4, std::string("\0\0\1\0", 4)) == 0)
+    return "image/x-icon";
+  else if (data.compare(0, 4, "wOFF") == 0)
+    return "font/woff";
+  else if (data.compare(0, 4, "wOF2") == 0)
+    return "font/woff2";
+  else if (data.compare(0, 4, "OTTO") == 0)
+    return "font/otf";
+  else if (data.compare(0, 4, std::string("\0\1\0\0", 4)) == 0)
+    return "font/ttf";
+  else if (data.find("<svg", 0) < 1024)
+    return "image/svg+xml";
+
+  // text files can not be told apart by their contents.
+  pos = path.find_last_of("./\\");
+  if (pos != std::string::npos && path[pos] == '.')
+    extension = path.substr(pos + 1);
+
+  if (extension == "css")
+    return "text/css";
+  else if (extension == "html" || extension == "htm")
+    return "text/html";
+  else if (extension == "txt")
+    return "text/plain";
+  return "application/octet-stream";
+}
+
+DataUri::Result DataUri::getUri(const std::string &path,
+                                const std::string &mimetype,
+                                std::string &uri) {
+  struct stat st;
+  char resolved[PATH_MAX];
+  std::map<std::string, Entry>::iterator i;
+  std::string key, type, data;
+  bool usebase64;
+  
+  if (realpath(path.c_str(), resolved) == NULL ||
+      stat(resolved, &st) != 0)
+    return NOT_FOUND;
+
+  if (maxSize > 0 && (size_t)st.st_size >= maxSize)
+    return TOO_LARGE;
+
+  key = resolved;
+  key.append(1, '\0');
+  key.append(mimetype);
+  i = entries.find(key);
+  
+  if (i != entries.end() &&
+      i->second.mtime == st.st_mtime &&
+      i->second.size == st.st_size) {
+    uri = i->second.uri;
+    return OK;
+  }
+
+#ifdef WITH_LIBGLOG
+  VLOG(2) << "Encoding data uri: " << resolved;
+#endif
+
+  std::ifstream in(resolved, std::ios::in | std::ios::binary);
+  if (!in.good())
+    return NOT_FOUND;
+  data.resize(st.st_size);
+  in.read(&data[0], st.st_size);
+  data.resize(in.gcount());
+
+  if (mimetype.empty()) {
+    type = sniffMimeType(data, path);
+    usebase64 = (type.compare(0, 5, "text/") != 0);
+    if (usebase64)
+      type.append(";base64");
+    else
+      type.append(";charset=UTF-8");
+  } else {
+    type = mimetype;
+    usebase64 = (type.size() >= 7 &&
+                 type.compare(type.size() - 7, 7, ";base64") == 0);
+  }
+
+  uri = "data:";
+  uri.append(type);
+  uri.append(1, ',');
+  if (usebase64)
+    base64((const unsigned char*)data.data(), data.size(), uri);
+  else
+    urlEncode(data, uri);
+
+  Entry &entry = entries[key];
+  entry.mtime = st.st_mtime;
+  entry.size = st.st_size;
+  entry.uri = uri;
+  return OK;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __DataUri_h__
+#define __DataUri_h__
+
+#include <string>
+#include <map>
+#include <ctime>
+#include <sys/types.h>
+
+/**
+ * Encodes files as data uris for the data-uri() function. The encoded
+ * uris are cached by path and mime type, and reused as long as the
+ * modification time and size of the file are unchanged, since the
+ * same icon is often inlined in several rulesets.
+ */
+class DataUri {
+public:
+  /**
+   * The default size limit, which is the limit of IE8.
+   */
+  static const size_t DEFAULT_MAX_SIZE = 32 * 1024;
+
+  enum Result {OK, NOT_FOUND, TOO_LARGE};
+
+private:
+  struct Entry {
+    time_t mtime;
+    off_t size;
+    std::string uri;
+  };
+  std::map<std::string, Entry> entries;
+  size_t maxSize;
+
+  /**
+   * Two base64 characters for each 12 bit value, so three bytes are
+   * encoded with two lookups.
+   */
+  static char table[4096 * 2];
+  static void initTable();
+
+  static std::string sniffMimeType(const std::string &data,
+                                   const std::string &path);
+  static void urlEncode(const std::string &data, std::string &out);
+  
+public:
+  DataUri();
+  
+  /**
+   * The cache shared by all stylesheets in the process.
+   */
+  static DataUri& getInstance();
+
+  /**
+   * Files of this size or larger are not inlined. 0 removes the
+   * limit.
+   */
+  void setMaxSize(size_t size);
+  size_t getMaxSize() const;
+
+  /**
+   * Create a data uri for the file, without the url() around it.
+   *
+   * @param mimetype  the mime type to use, or an empty string to find
+   *                  it from the contents of the file. Content is
+   *                  base64 encoded if the mime type ends with
+   *                  ';base64', or if it was not given and is not
+   *                  text.
+   */
+  Result getUri(const std::string &path, const std::string &mimetype,
+                std::string &uri);
+
+  /**
+   * Append the base64 encoding of the data to out.
+   */
+  static void base64(const unsigned char* data, size_t length,
+                     std::string &out);
+};
+
+#endif
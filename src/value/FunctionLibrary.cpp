@@ -21,6 +21,13 @@
 
 #include "FunctionLibrary.h"
 
+FunctionLibrary::~FunctionLibrary() {
+  std::map<std::string, FuncInfo*>::iterator i;
+
+  for (i = map.begin(); i != map.end(); i++)
+    delete i->second;
+}
+
 const FuncInfo* FunctionLibrary::getFunction(const char* functionName) const {
   std::map<std::string, FuncInfo*>::const_iterator i =
     map.find(functionName);
@@ -34,10 +41,12 @@ const FuncInfo* FunctionLibrary::getFunction(const char* functionName) const {
 void FunctionLibrary::push(string name, const char* parameterTypes,
                            Value* (*func)(const vector<const Value*> &arguments))
 {
-  FuncInfo* fi = new FuncInfo();
+  FuncInfo* &fi = map[name];
+
+  if (fi == NULL)
+    fi = new FuncInfo();
   fi->parameterTypes = parameterTypes;
   fi->func = func;
-  map[name] = fi;
 }
 
 bool FunctionLibrary::checkArguments(const FuncInfo* fi,
@@ -38,6 +38,8 @@ private:
 
 
 public:
+  virtual ~FunctionLibrary();
+  
   const FuncInfo* getFunction(const char* functionName) const;
 
   void push(string name, const char* parameterTypes,
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "ImageCache.h"
+#include "../css/IOException.h"
+
+#include <config.h>
+
+#ifdef WITH_LIBGLOG
+#include <glog/logging.h>
+#endif
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+ImageCache::Entry::Entry() {
+  mtime = 0;
+  size = 0;
+  loaded = false;
+  found = false;
+}
+
+ImageCache& ImageCache::getInstance() {
+  static ImageCache cache;
+  return cache;
+}
+
+ImageCache::Entry* ImageCache::getEntry(const std::string &path) {
+  struct stat st;
+  char resolved[PATH_MAX];
+  std::map<std::string, Entry>::iterator i;
+  Entry* entry;
+  
+  if (realpath(path.c_str(), resolved) == NULL ||
+      stat(resolved, &st) != 0)
+    return NULL;
+
+  i = entries.find(resolved);
+  if (i == entries.end())
+    i = entries.insert(std::pair<std::string, Entry>(resolved,
+                                                     Entry())).first;
+  entry = &i->second;
+  
+  if (!entry->loaded ||
+      entry->mtime != st.st_mtime ||
+      entry->size != st.st_size) {
+    
+#ifdef WITH_LIBGLOG
+    VLOG(3) << "Image cache miss: " << resolved;
+#endif
+    
+    entry->mtime = st.st_mtime;
+    entry->size = st.st_size;
+    entry->loaded = false;
+    entry->found = false;
+    entry->img = UrlValue_Img();
+  }
+  return entry;
+}
+
+void ImageCache::load(const char* filename) {
+  std::ifstream in(filename);
+  std::string line, path;
+  long long mtime, size;
+  unsigned int red, green, blue;
+  Entry entry;
+
+  if (!in.good())
+    return;
+
+  // mtime size found hasBackground width height red green blue path
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    
+    if (!(fields >> mtime >> size >> entry.found >>
+          entry.img.hasBackground >> entry.img.width >> entry.img.height >>
+          red >> green >> blue) ||
+        fields.get() != ' ' ||
+        !std::getline(fields, path)) {
+      
+#ifdef WITH_LIBGLOG
+      LOG(WARNING) << filename << ": Skipping invalid image cache entry: " <<
+        line;
+#else
+      std::cerr << filename << ": Skipping invalid image cache entry: " <<
+        line << std::endl;
+#endif
+      continue;
+    }
+    entry.mtime = mtime;
+    entry.size = size;
+    entry.loaded = true;
+    entry.img.background.setRGB(red, green, blue);
+    entries[path] = entry;
+  }
+}
+
+void ImageCache::save(const char* filename) const {
+  std::ofstream out(filename);
+  std::map<std::string, Entry>::const_iterator i;
+  const Entry* entry;
+  
+  if (!out.good())
+    throw new IOException("Error opening image cache file");
+  
+  for (i = entries.begin(); i != entries.end(); i++) {
+    entry = &i->second;
+    if (!entry->loaded)
+      continue;
+    
+    out << (long long)entry->mtime << " " <<
+      (long long)entry->size << " " <<
+      entry->found << " " <<
+      entry->img.hasBackground << " " <<
+      entry->img.width << " " <<
+      entry->img.height << " " <<
+      entry->img.background.getRed() << " " <<
+      entry->img.background.getGreen() << " " <<
+      entry->img.background.getBlue() << " " <<
+      i->first << "\n";
+  }
+  if (out.fail())
+    throw new IOException("Error writing image cache file");
+}
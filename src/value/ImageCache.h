@@ -0,0 +1,83 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __ImageCache_h__
+#define __ImageCache_h__
+
+#include "UrlValue.h"
+
+#include <string>
+#include <map>
+#include <ctime>
+
+/**
+ * Dimensions and background colors of the images used by the
+ * imgwidth(), imgheight() and imgbackground() functions, so an image
+ * is only read once per process. Entries are keyed by the resolved
+ * path and are only used if the modification time and size of the
+ * file have not changed.
+ *
+ * The cache can be saved to a file and loaded in the next run, so
+ * images that have not changed are not read again.
+ */
+class ImageCache {
+public:
+  struct Entry {
+    time_t mtime;
+    off_t size;
+    /**
+     * False if the entry has not been filled since the file changed.
+     */
+    bool loaded;
+    /**
+     * False if the file could not be read as an image.
+     */
+    bool found;
+    UrlValue_Img img;
+
+    Entry();
+  };
+
+private:
+  std::map<std::string, Entry> entries;
+
+public:
+  /**
+   * The cache shared by all stylesheets in the process.
+   */
+  static ImageCache& getInstance();
+
+  /**
+   * Returns the entry for the file, or NULL if the file does not
+   * exist. If the file changed, the entry is reset and has to be filled
+   * by the caller.
+   */
+  Entry* getEntry(const std::string &path);
+
+  /**
+   * Read the entries saved by a previous run. A missing file is not
+   * an error; the cache starts empty.
+   */
+  void load(const char* filename);
+  void save(const char* filename) const;
+};
+
+#endif
@@ -0,0 +1,375 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "ImageProbe.h"
+
+#include <config.h>
+
+#ifdef WITH_LIBGLOG
+#include <glog/logging.h>
+#endif
+
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+/**
+ * The number of bytes that is read to find the type of the file. GIF,
+ * WebP and SVG are probed from these bytes only.
+ */
+#define IMAGEPROBE_HEADER_SIZE 1024
+
+static unsigned int readUint16BE(const unsigned char* data) {
+  return (data[0] << 8) | data[1];
+}
+static unsigned int readUint32BE(const unsigned char* data) {
+  return ((unsigned int)data[0] << 24) | (data[1] << 16) |
+    (data[2] << 8) | data[3];
+}
+static unsigned int readUint16LE(const unsigned char* data) {
+  return data[0] | (data[1] << 8);
+}
+static unsigned int readUint24LE(const unsigned char* data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16);
+}
+
+ImageProbe::Type ImageProbe::probe(const std::string &path,
+                                   UrlValue_Img &img) {
+  unsigned char header[IMAGEPROBE_HEADER_SIZE];
+  size_t length;
+  Type type = NONE;
+  FILE* file = fopen(path.c_str(), "rb");
+
+  if (file == NULL)
+    return NONE;
+
+  length = fread(header, 1, sizeof(header), file);
+
+  // images without a background color in the header get white, like
+  // png files without a bKGD chunk.
+  img.background.setRGB(255, 255, 255);
+  img.hasBackground = true;
+  
+  if (length >= 8 &&
+      memcmp(header, "\x89PNG\r\n\x1a\n", 8) == 0) {
+    if (fseek(file, 8, SEEK_SET) == 0 && probePng(file, img))
+      type = PNG;
+    
+  } else if (length >= 3 &&
+             memcmp(header, "\xff\xd8\xff", 3) == 0) {
+    if (fseek(file, 2, SEEK_SET) == 0 && probeJpeg(file, img))
+      type = JPEG;
+
+  } else if (probeGif(header, length, img)) {
+    type = GIF;
+  } else if (probeWebp(header, length, img)) {
+    type = WEBP;
+  } else if (probeSvg(header, length, img)) {
+    type = SVG;
+  }
+
+  fclose(file);
+
+  if (type == NONE)
+    img = UrlValue_Img();
+
+#ifdef WITH_LIBGLOG
+  VLOG(3) << "Image " << path << ": type " << type << ", width: " <<
+    img.width << ", height: " << img.height;
+#endif
+
+  return type;
+}
+
+bool ImageProbe::probePng(FILE* file, UrlValue_Img &img) {
+  unsigned char chunk[8];
+  unsigned char palette[256 * 3];
+  unsigned char data[13];
+  unsigned int length, colors = 0;
+  unsigned char colorType;
+
+  // IHDR is always the first chunk.
+  if (fread(chunk, 1, 8, file) != 8 ||
+      memcmp(chunk + 4, "IHDR", 4) != 0 ||
+      readUint32BE(chunk) != 13 ||
+      fread(data, 1, 13, file) != 13 ||
+      fseek(file, 4, SEEK_CUR) != 0)
+    return false;
+
+  img.width = readUint32BE(data);
+  img.height = readUint32BE(data + 4);
+  colorType = data[9];
+
+  // The PLTE and bKGD chunks come before the image data.
+  while (fread(chunk, 1, 8, file) == 8) {
+    length = readUint32BE(chunk);
+    
+    if (memcmp(chunk + 4, "IDAT", 4) == 0 ||
+        memcmp(chunk + 4, "IEND", 4) == 0)
+      break;
+
+    if (memcmp(chunk + 4, "PLTE", 4) == 0 &&
+        length <= sizeof(palette)) {
+      if (fread(palette, 1, length, file) != length)
+        break;
+      colors = length / 3;
+      length = 0;
+      
+    } else if (memcmp(chunk + 4, "bKGD", 4) == 0 &&
+               length <= 6) {
+      if (fread(data, 1, length, file) != length)
+        break;
+
+      if (colorType == 3 && length == 1 && data[0] < colors) {
+        img.background.setRGB(palette[data[0] * 3],
+                              palette[data[0] * 3 + 1],
+                              palette[data[0] * 3 + 2]);
+      } else if ((colorType == 0 || colorType == 4) && length == 2) {
+        img.background.setRGB(readUint16BE(data),
+                              readUint16BE(data),
+                              readUint16BE(data));
+      } else if ((colorType == 2 || colorType == 6) && length == 6) {
+        img.background.setRGB(readUint16BE(data),
+                              readUint16BE(data + 2),
+                              readUint16BE(data + 4));
+      }
+      break;
+    }
+
+    // skip the data and the crc
+    if (fseek(file, length + 4, SEEK_CUR) != 0)
+      break;
+  }
+  return true;
+}
+
+bool ImageProbe::probeJpeg(FILE* file, UrlValue_Img &img) {
+  unsigned char segment[8];
+  int marker;
+  unsigned int length;
+
+  while ((marker = fgetc(file)) != EOF) {
+    if (marker != 0xFF)
+      return false;
+
+    // markers can be padded with any number of 0xFF bytes
+    while ((marker = fgetc(file)) == 0xFF) {
+    }
+    
+    // markers without a length
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7))
+      continue;
+
+    // start of scan or end of image: there was no frame header.
+    if (marker == EOF || marker == 0xDA || marker == 0xD9 ||
+        fread(segment, 1, 2, file) != 2)
+      return false;
+
+    length = readUint16BE(segment);
+    if (length < 2)
+      return false;
+    
+    // SOF0-SOF15, except DHT, JPG and DAC
+    if (marker >= 0xC0 && marker <= 0xCF &&
+        marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+      if (length < 8 ||
+          fread(segment, 1, 6, file) != 6)
+        return false;
+      
+      img.height = readUint16BE(segment + 1);
+      img.width = readUint16BE(segment + 3);
+
+      // The background is the color of the corners, which requires
+      // decoding the image. Only color images have one; others are
+      // black.
+      if (segment[5] == 3) {
+        img.hasBackground = false;
+      } else
+        img.background.setRGB(0, 0, 0);
+      return true;
+    }
+    
+    if (fseek(file, length - 2, SEEK_CUR) != 0)
+      return false;
+  }
+  return false;
+}
+
+bool ImageProbe::probeGif(const unsigned char* header, size_t length,
+                          UrlValue_Img &img) {
+  const unsigned char* color;
+  
+  if (length < 13 ||
+      (memcmp(header, "GIF87a", 6) != 0 &&
+       memcmp(header, "GIF89a", 6) != 0))
+    return false;
+
+  img.width = readUint16LE(header + 6);
+  img.height = readUint16LE(header + 8);
+
+  // the background color index points into the global color table.
+  if ((header[10] & 0x80) &&
+      (size_t)(13 + header[11] * 3 + 3) <= length) {
+    color = header + 13 + header[11] * 3;
+    img.background.setRGB(color[0], color[1], color[2]);
+  }
+  return true;
+}
+
+bool ImageProbe::probeWebp(const unsigned char* header, size_t length,
+                           UrlValue_Img &img) {
+  unsigned int bits;
+  
+  if (length < 30 ||
+      memcmp(header, "RIFF", 4) != 0 ||
+      memcmp(header + 8, "WEBP", 4) != 0)
+    return false;
+
+  if (memcmp(header + 12, "VP8 ", 4) == 0) {
+    // lossy: a frame tag followed by the start code
+    if (memcmp(header + 23, "\x9d\x01\x2a", 3) != 0)
+      return false;
+    img.width = readUint16LE(header + 26) & 0x3FFF;
+    img.height = readUint16LE(header + 28) & 0x3FFF;
+    
+  } else if (memcmp(header + 12, "VP8L", 4) == 0) {
+    // lossless: 14 bits each for width - 1 and height - 1
+    if (header[20] != 0x2F)
+      return false;
+    bits = readUint24LE(header + 21) | (header[24] << 24);
+    img.width = (bits & 0x3FFF) + 1;
+    img.height = ((bits >> 14) & 0x3FFF) + 1;
+
+  } else if (memcmp(header + 12, "VP8X", 4) == 0) {
+    // extended: the canvas size, 24 bits each
+    img.width = readUint24LE(header + 24) + 1;
+    img.height = readUint24LE(header + 27) + 1;
+  } else
+    return false;
+  return true;
+}
+
+bool ImageProbe::probeSvg(const unsigned char* header, size_t length,
+                          UrlValue_Img &img) {
+  std::string text((const char*)header, length);
+  std::string tag, value;
+  size_t start, end;
+  double width = -1, height = -1;
+  double viewbox[4];
+  const char* pos;
+  char* num_end;
+  int i;
+
+  start = text.find("<svg");
+  if (start == std::string::npos ||
+      (start + 4 < text.size() &&
+       !isspace(text[start + 4]) && text[start + 4] != '>'))
+    return false;
+  end = text.find('>', start);
+  if (end == std::string::npos)
+    return false;
+  tag = text.substr(start, end - start);
+
+  if (getSvgAttribute(tag, "width", value) &&
+      !parseSvgLength(value, width))
+    width = -1;
+  if (getSvgAttribute(tag, "height", value) &&
+      !parseSvgLength(value, height))
+    height = -1;
+  
+  // Use the size of the viewBox when width or height is missing or
+  // not in pixels.
+  if ((width < 0 || height < 0) &&
+      getSvgAttribute(tag, "viewBox", value)) {
+    pos = value.c_str();
+    
+    for (i = 0; i < 4; i++) {
+      while (*pos == ',' || isspace(*pos))
+        pos++;
+      viewbox[i] = strtod(pos, &num_end);
+      if (num_end == pos)
+        break;
+      pos = num_end;
+    }
+
+    if (i == 4) {
+      if (width < 0 && height < 0) {
+        width = viewbox[2];
+        height = viewbox[3];
+      } else if (width < 0 && viewbox[3] > 0) {
+        width = height * viewbox[2] / viewbox[3];
+      } else if (height < 0 && viewbox[2] > 0) {
+        height = width * viewbox[3] / viewbox[2];
+      }
+    }
+  }
+
+  img.width = (width > 0) ? (unsigned int)(width + .5) : 0;
+  img.height = (height > 0) ? (unsigned int)(height + .5) : 0;
+  return true;
+}
+
+bool ImageProbe::getSvgAttribute(const std::string &tag, const char* name,
+                                 std::string &value) {
+  size_t pos = 0, len = strlen(name), end;
+  char quote;
+  
+  while ((pos = tag.find(name, pos)) != std::string::npos) {
+    end = pos + len;
+    
+    // the name has to be a whole attribute name
+    if (!isspace(tag[pos - 1])) {
+      pos = end;
+      continue;
+    }
+    while (end < tag.size() && isspace(tag[end]))
+      end++;
+    if (end >= tag.size() || tag[end] != '=') {
+      pos = end;
+      continue;
+    }
+    end++;
+    while (end < tag.size() && isspace(tag[end]))
+      end++;
+    if (end >= tag.size() || (tag[end] != '"' && tag[end] != '\''))
+      return false;
+
+    quote = tag[end++];
+    pos = tag.find(quote, end);
+    if (pos == std::string::npos)
+      return false;
+    value = tag.substr(end, pos - end);
+    return true;
+  }
+  return false;
+}
+
+bool ImageProbe::parseSvgLength(const std::string &value, double &length) {
+  const char* start = value.c_str();
+  char* end;
+
+  length = strtod(start, &end);
+  if (end == start)
+    return false;
+  while (isspace(*end))
+    end++;
+  return (*end == '\0' || strcmp(end, "px") == 0);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __ImageProbe_h__
+#define __ImageProbe_h__
+
+#include "UrlValue.h"
+
+#include <string>
+#include <cstdio>
+
+/**
+ * Reads the width, height and, where the header has one, the
+ * background color of an image from the file header, without an image
+ * library or decoding any pixels.
+ *
+ * Supported are PNG (IHDR, PLTE and bKGD chunks), JPEG (SOFn
+ * markers), GIF, WebP (VP8, VP8L and VP8X) and SVG (width, height and
+ * viewBox attributes).
+ */
+class ImageProbe {
+public:
+  enum Type {NONE, PNG, JPEG, GIF, WEBP, SVG};
+
+  /**
+   * Fill in img from the header of the file.
+   *
+   * @return the type of the image or NONE if the file could not be
+   *         read or is not a supported image.
+   */
+  static Type probe(const std::string &path, UrlValue_Img &img);
+
+private:
+  static bool probePng(FILE* file, UrlValue_Img &img);
+  static bool probeJpeg(FILE* file, UrlValue_Img &img);
+  static bool probeGif(const unsigned char* header, size_t length,
+                       UrlValue_Img &img);
+  static bool probeWebp(const unsigned char* header, size_t length,
+                        UrlValue_Img &img);
+  static bool probeSvg(const unsigned char* header, size_t length,
+                       UrlValue_Img &img);
+
+  /**
+   * Find the value of an attribute in the svg start tag.
+   */
+  static bool getSvgAttribute(const std::string &tag, const char* name,
+                              std::string &value);
+  /**
+   * Parse a length in pixels. Lengths with other units fail.
+   */
+  static bool parseSvgLength(const std::string &value, double &length);
+};
+
+#endif
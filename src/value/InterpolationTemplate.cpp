@@ -0,0 +1,51 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "InterpolationTemplate.h"
+
+InterpolationTemplate::InterpolationTemplate(const std::string &str) {
+  size_t pos = 0, start, end;
+  std::string key;
+
+  while ((start = str.find("@{", pos)) != std::string::npos &&
+         (end = str.find("}", start)) != std::string::npos) {
+    literals.push_back(str.substr(pos, start - pos));
+
+    key = "@";
+    key.append(str, start + 2, end - (start + 2));
+    variables.push_back(key);
+
+    pos = end + 1;
+  }
+  literals.push_back(str.substr(pos));
+}
+
+size_t InterpolationTemplate::getVariableCount() const {
+  return variables.size();
+}
+
+const std::string& InterpolationTemplate::getLiteral(size_t i) const {
+  return literals[i];
+}
+
+const std::string& InterpolationTemplate::getVariable(size_t i) const {
+  return variables[i];
+}
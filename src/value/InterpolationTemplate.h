@@ -0,0 +1,54 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __InterpolationTemplate_h__
+#define __InterpolationTemplate_h__
+
+#include <string>
+#include <vector>
+
+/**
+ * A string containing '@{variable}' references, split into the
+ * literal text and the variable names so it only has to be scanned
+ * once.
+ */
+class InterpolationTemplate {
+private:
+  /**
+   * Literal text; the variable at index i follows the literal at
+   * index i. There is always one more literal than variables.
+   */
+  std::vector<std::string> literals;
+
+  /**
+   * Variable keys, including the '@'.
+   */
+  std::vector<std::string> variables;
+  
+public:
+  InterpolationTemplate(const std::string &str);
+
+  size_t getVariableCount() const;
+  const std::string& getLiteral(size_t i) const;
+  const std::string& getVariable(size_t i) const;
+};
+
+#endif
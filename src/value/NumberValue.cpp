@@ -21,8 +21,22 @@
 
 #include "NumberValue.h"
 
+#include <config.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef HAVE_CHARCONV
+#include <charconv>
+#endif
+
 NumberValue::NumberValue(const Token &token) {
+  size_t length;
+  
+  unitId = UnitRegistry::UNKNOWN_UNIT;
   tokens.push_back(token);
+  setLocation(token);
+  length = parseNumber(token, value);
   
   switch(token.type) {
   case Token::NUMBER:
@@ -33,6 +47,8 @@ NumberValue::NumberValue(const Token &token) {
     break;
   case Token::DIMENSION:
     type = DIMENSION;
+    dimensionUnit = token.substr(length);
+    unitId = UnitRegistry::findUnit(dimensionUnit);
     break;
   default:
     throw new ValueException("Token used for Value that isn't a "
@@ -40,6 +56,7 @@ NumberValue::NumberValue(const Token &token) {
   }
 }
 NumberValue::NumberValue(double value) {
+  unitId = UnitRegistry::UNKNOWN_UNIT;
   tokens.push_back(Token("", Token::NUMBER, 0,0,"generated"));
   type = NUMBER;
   setValue(value);
@@ -71,18 +88,23 @@ NumberValue::NumberValue(double value, Token::Type type, const
     break;
   }
 
-  ostringstream stm;
-  stm << setprecision(10) << value;
-  if (type == Token::DIMENSION)
-    stm << *unit;
-  else if (type == Token::PERCENTAGE)
-    stm << "%";
-  tokens.front() = stm.str();
+  if (type == Token::DIMENSION) {
+    dimensionUnit = *unit;
+    unitId = UnitRegistry::findUnit(*unit);
+  } else
+    unitId = UnitRegistry::UNKNOWN_UNIT;
+  setValue(value);
 }
 
 NumberValue::NumberValue(const NumberValue &n) {
-  tokens.push_back(n.getTokens()->front());
-  this->type = n.type;
+  tokens = n.tokens;
+  setLocation(n);
+  type = n.type;
+  value = n.value;
+  dimensionUnit = n.dimensionUnit;
+  unitId = n.unitId;
+  if (n.isModified())
+    setModified();
 }
 
 NumberValue::~NumberValue() {
@@ -92,39 +114,37 @@ NumberValue::~NumberValue() {
 void NumberValue::verifyUnits(const NumberValue &n) {
   if (type == Value::DIMENSION &&
       n.type == Value::DIMENSION &&
-      getUnit().compare(n.getUnit()) != 0) {
+      (unitId != n.unitId ||
+       (unitId == UnitRegistry::UNKNOWN_UNIT &&
+        dimensionUnit != n.dimensionUnit))) {
     
-    setValue(convert(n.getUnit()));
-    setUnit(n.getUnit());
+    setValue(convert(n.dimensionUnit, n.unitId));
+    dimensionUnit = n.dimensionUnit;
+    unitId = n.unitId;
   }
 }
 
 double NumberValue::convert(const std::string &unit) const {
-  UnitValue::UnitGroup group = UnitValue::getUnitGroup(unit);
+  return convert(unit, UnitRegistry::findUnit(unit));
+}
+
+double NumberValue::convert(const std::string &unit,
+                            UnitRegistry::Unit id) const {
   double value = getValue();
 
-  if (UnitValue::getUnitGroup(getUnit()) == group) {
-    
-    switch(group) {
-    case UnitValue::LENGTH:
-      value = UnitValue::lengthToPx(value, getUnit());
-      return UnitValue::pxToLength(value, unit);
-
-    case UnitValue::TIME:
-      value = UnitValue::timeToMs(value, getUnit());
-      return UnitValue::msToTime(value, unit);
-
-    case UnitValue::ANGLE:
-      value = UnitValue::angleToRad(value, getUnit());
-      return UnitValue::radToAngle(value, unit);
-      
-    default:
-      return value;
-    }
-  } else
-    throw new ValueException("Can't do math on dimensions with "
-                             "different units.", *this->getTokens());
+  if (type == NUMBER || unit.empty())
+    return value;
 
+  if (type == DIMENSION &&
+      unitId != UnitRegistry::UNKNOWN_UNIT &&
+      id != UnitRegistry::UNKNOWN_UNIT) {
+    if (UnitRegistry::convert(value, unitId, id))
+      return value;
+  } else if (getUnit() == unit)
+    return value;
+  
+  throw new ValueException("Can't do math on dimensions with "
+                           "different units.", *this->getTokens());
 }
 
 Value* NumberValue::add(const Value &v) const {
@@ -236,7 +256,8 @@ BooleanValue* NumberValue::equals(const Value &v) const {
 
   if (isNumber(v)) {
     n = static_cast<const NumberValue*>(&v);
-    return new BooleanValue(convert(n->getUnit()) == n->getValue());
+    return new BooleanValue(convert(n->getUnit(), n->unitId) ==
+                            n->getValue());
   } else {
     throw new ValueException("You can only compare a number "
                              "with a *number*.", *this->getTokens());
@@ -248,7 +269,8 @@ BooleanValue* NumberValue::lessThan(const Value &v) const {
 
   if (isNumber(v)) {
     n = static_cast<const NumberValue*>(&v);
-    return new BooleanValue(convert(n->getUnit()) < n->getValue());
+    return new BooleanValue(convert(n->getUnit(), n->unitId) <
+                            n->getValue());
   } else {
     throw new ValueException("You can only compare a number "
                              "with a *number*.", *this->getTokens());
@@ -257,69 +279,102 @@ BooleanValue* NumberValue::lessThan(const Value &v) const {
 
 void NumberValue::setType(const NumberValue &n) {
   type = n.type;
-  if (n.type == DIMENSION)
-    setUnit(n.getUnit());
-  else if (n.type == PERCENTAGE) 
-    tokens.front().type = Token::PERCENTAGE;
+  if (n.type == DIMENSION) {
+    dimensionUnit = n.dimensionUnit;
+    unitId = n.unitId;
+    setModified();
+  } else if (n.type == PERCENTAGE) 
+    setModified();
   else if (n.type == NUMBER) {
     setUnit("");
   }
 }
 
 double NumberValue::getValue() const {
-  string number;
-  istringstream stm;
-  double ret;
-  char c;
-
-  for (unsigned int i = 0; i < tokens.front().size(); i++) {
-    c = tokens.front()[i];
-    if (!isdigit(c) && c != '.' && c != '-') {
-      number = tokens.front().substr(0, i);
-      break;
-    }
-  }
-  if (number == "")
-    number = tokens.front();
-  stm.str(number);
-  stm >>ret;
-  return ret;
+  return value;
 }
 string NumberValue::getUnit () const {
-  char c;
-  unsigned int i;
-  
-  for (i = 0; i < tokens.front().size(); i++) {
-    c = tokens.front()[i];
-    if (!isdigit(c) && c != '.' && c != '-')
-      return tokens.front().substr(i);
-  }
-  return string("");
+  if (type == DIMENSION)
+    return dimensionUnit;
+  else if (type == PERCENTAGE)
+    return "%";
+  else
+    return "";
 }
 
 void NumberValue::setUnit(string unit) {
-  ostringstream stm;
-  stm << setprecision(10) << getValue();
-  stm << unit;
-  tokens.front() = stm.str();
+  dimensionUnit = unit;
+  unitId = UnitRegistry::findUnit(unit);
   
-  if (unit.length() == 0) {
+  if (unit.length() == 0) 
     type = NUMBER;
-    tokens.front().type = Token::NUMBER;
-  } else {
+  else 
     type = DIMENSION;
-    tokens.front().type = Token::DIMENSION;
-  }
+  setModified();
 }
 
 void NumberValue::setValue(double d) {
-  ostringstream stm;
-  stm << setprecision(10) << d;
-  if (type == DIMENSION)
-    stm << getUnit();
-  else if (type == PERCENTAGE)
-    stm << "%";
-  tokens.front() = stm.str();
+  value = d;
+  setModified();
+}
+
+void NumberValue::updateTokens() const {
+  char buffer[32];
+  size_t length = formatNumber(value, 10, buffer, sizeof(buffer));
+  Token &token = tokens.front();
+  
+  token.assign(buffer, length);
+
+  switch (type) {
+  case DIMENSION:
+    token.append(dimensionUnit);
+    token.type = Token::DIMENSION;
+    break;
+  case PERCENTAGE:
+    token.append('%');
+    token.type = Token::PERCENTAGE;
+    break;
+  default:
+    token.type = Token::NUMBER;
+  }
+}
+
+size_t NumberValue::parseNumber(const std::string &str, double &d) {
+  size_t start = 0, end;
+  char c;
+
+  d = 0;
+  
+  if (!str.empty() && str[0] == '+')
+    start = 1;
+
+  for (end = start; end < str.size(); end++) {
+    c = str[end];
+    if (!isdigit(c) && c != '.' && c != '-')
+      break;
+  }
+  if (end == start)
+    return end;
+
+#ifdef HAVE_CHARCONV
+  std::from_chars(str.data() + start, str.data() + end, d);
+#else
+  // strtod() uses the decimal point of the C locale, which is never
+  // changed by lessc.
+  std::string number = str.substr(start, end - start);
+  d = std::strtod(number.c_str(), NULL);
+#endif
+  return end;
+}
+
+size_t NumberValue::formatNumber(double d, int precision, char* buffer,
+                                 size_t size) {
+#ifdef HAVE_CHARCONV
+  return std::to_chars(buffer, buffer + size, d,
+                       std::chars_format::general, precision).ptr - buffer;
+#else
+  return std::snprintf(buffer, size, "%.*g", precision, d);
+#endif
 }
 
 bool NumberValue::isNumber(const Value &val) {
@@ -444,19 +499,11 @@ Value* NumberValue::sin(const vector<const Value*> &args) {
 
   NumberValue* n = new NumberValue(*(const NumberValue*)args[0]);
   double val = n->getValue();
-  std::string unit;
-  
 
-  if (n->type == Value::DIMENSION) {
-    unit = n->getUnit();
-    if(unit.compare("rad") != 0 &&
-       unit.compare("deg") != 0 &&
-       unit.compare("grad") != 0 &&
-       unit.compare("turn") != 0) {
-      throw new ValueException("sin() requires rad, deg, "
-                               "grad or turn units.", *args[0]->getTokens());
-    }
-    val = UnitValue::angleToRad(val, unit);
+  if (n->type == Value::DIMENSION &&
+      !UnitRegistry::convert(val, n->unitId, UnitRegistry::RAD)) {
+    throw new ValueException("sin() requires rad, deg, "
+                             "grad or turn units.", *args[0]->getTokens());
   }
     
   n->setValue(std::sin(val));
@@ -480,18 +527,11 @@ Value* NumberValue::cos(const vector<const Value*> &args) {
   }
   NumberValue* n = new NumberValue(*(const NumberValue*)args[0]);
   double val = n->getValue();
-  std::string unit;
-    
-  if (n->type == Value::DIMENSION) {
-    unit = n->getUnit();
-    if(unit.compare("rad") != 0 &&
-       unit.compare("deg") != 0 &&
-       unit.compare("grad") != 0 &&
-       unit.compare("turn") != 0) {
-      throw new ValueException("cos() requires rad, deg, "
-                               "grad or turn units.", *args[0]->getTokens());
-    }
-    val = UnitValue::angleToRad(val, unit);
+
+  if (n->type == Value::DIMENSION &&
+      !UnitRegistry::convert(val, n->unitId, UnitRegistry::RAD)) {
+    throw new ValueException("cos() requires rad, deg, "
+                             "grad or turn units.", *args[0]->getTokens());
   }
 
   n->setValue(std::cos(val));
@@ -515,18 +555,11 @@ Value* NumberValue::tan(const vector<const Value*> &args) {
   }
   NumberValue* n = new NumberValue(*(const NumberValue*)args[0]);
   double val = n->getValue();
-  std::string unit;
-    
-  if (n->type == Value::DIMENSION) {
-    unit = n->getUnit();
-    if(unit.compare("rad") != 0 &&
-       unit.compare("deg") != 0 &&
-       unit.compare("grad") != 0 &&
-       unit.compare("turn") != 0) {
-      throw new ValueException("ta() requires rad, deg, "
-                               "grad or turn units.", *args[0]->getTokens());
-    }
-    val = UnitValue::angleToRad(val, unit);
+
+  if (n->type == Value::DIMENSION &&
+      !UnitRegistry::convert(val, n->unitId, UnitRegistry::RAD)) {
+    throw new ValueException("ta() requires rad, deg, "
+                             "grad or turn units.", *args[0]->getTokens());
   }
 
   n->setValue(std::tan(val));
@@ -25,17 +25,52 @@
 #include "Value.h"
 #include "StringValue.h"
 #include "UnitValue.h"
+#include "UnitRegistry.h"
 #include <vector>
 #include <cmath>
 class FunctionLibrary;
 
 class NumberValue: public Value {
+  /**
+   * The numeric value of the token, so it doesn't have to be parsed
+   * from the token every time it is used.
+   */
+  double value;
+
+  /**
+   * The unit of dimensions.
+   */
+  std::string dimensionUnit;
+  UnitRegistry::Unit unitId;
+  
   static bool isNumber(const Value &val);
 
   void verifyUnits(const NumberValue &n);
   double convert(const std::string &unit) const;
+  double convert(const std::string &unit, UnitRegistry::Unit id) const;
+
+  /**
+   * Parse the number at the start of str. Parsing does not depend on
+   * the locale.
+   *
+   * @return the number of characters in the number.
+   */
+  static size_t parseNumber(const std::string &str, double &d);
+
+protected:
+  virtual void updateTokens() const;
   
 public:
+  /**
+   * Write d to buffer with up to precision significant digits, in the
+   * shortest of fixed or exponent notation ("%g"). Formatting does not
+   * depend on the locale.
+   *
+   * @return the number of characters written.
+   */
+  static size_t formatNumber(double d, int precision, char* buffer,
+                             size_t size);
+  
   NumberValue(const Token &token);
   NumberValue(double value);
   NumberValue(double value, Token::Type type,
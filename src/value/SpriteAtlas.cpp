@@ -0,0 +1,241 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "SpriteAtlas.h"
+#include "ImageProbe.h"
+#include "../css/IOException.h"
+
+#include <config.h>
+
+#ifdef WITH_LIBGLOG
+#include <glog/logging.h>
+#endif
+
+#ifdef WITH_LIBPNG
+#include <png.h>
+#include <cstdio>
+#endif
+
+std::map<std::string, SpriteAtlas*> SpriteAtlas::atlases;
+
+SpriteAtlas::SpriteAtlas(const std::string &filename) {
+  this->filename = filename;
+  width = 0;
+  height = 0;
+}
+
+SpriteAtlas::~SpriteAtlas() {
+}
+
+SpriteAtlas& SpriteAtlas::getAtlas(const std::string &filename) {
+  std::map<std::string, SpriteAtlas*>::iterator i = atlases.find(filename);
+
+  if (i == atlases.end()) {
+    i = atlases.insert(std::pair<std::string, SpriteAtlas*>
+                       (filename, new SpriteAtlas(filename))).first;
+  }
+  return *i->second;
+}
+
+void SpriteAtlas::writeAtlases() {
+  std::map<std::string, SpriteAtlas*>::iterator i;
+
+  for (i = atlases.begin(); i != atlases.end(); i++) {
+    if (!i->second->sprites.empty())
+      i->second->write();
+    delete i->second;
+  }
+  atlases.clear();
+}
+
+const SpriteAtlas::Sprite* SpriteAtlas::addSprite(const std::string &path) {
+  std::map<std::string, size_t>::iterator i = index.find(path);
+  UrlValue_Img img;
+  Sprite sprite;
+  
+  if (i != index.end())
+    return &sprites[i->second];
+
+  if (ImageProbe::probe(path, img) != ImageProbe::PNG)
+    return NULL;
+
+  sprite.path = path;
+  sprite.width = img.width;
+  sprite.height = img.height;
+  place(sprite);
+
+#ifdef WITH_LIBGLOG
+  VLOG(2) << "Sprite " << path << " at " << sprite.x << "," << sprite.y <<
+    " in " << filename;
+#endif
+  
+  index[path] = sprites.size();
+  sprites.push_back(sprite);
+  return &sprites.back();
+}
+
+void SpriteAtlas::place(Sprite &sprite) {
+  std::vector<Shelf>::iterator i;
+  unsigned int maxWidth = (width > MAX_WIDTH) ? width : MAX_WIDTH;
+  Shelf shelf;
+
+  // the first shelf that is high enough and has room left.
+  for (i = shelves.begin(); i != shelves.end(); i++) {
+    if (sprite.height <= (*i).height &&
+        (*i).width + sprite.width <= maxWidth)
+      break;
+  }
+
+  if (i == shelves.end()) {
+    shelf.y = height;
+    shelf.height = sprite.height;
+    shelf.width = 0;
+    height += sprite.height;
+    shelves.push_back(shelf);
+    i = shelves.end() - 1;
+  }
+
+  sprite.x = (*i).width;
+  sprite.y = (*i).y;
+  (*i).width += sprite.width;
+  
+  if ((*i).width > width)
+    width = (*i).width;
+}
+
+#ifdef WITH_LIBPNG
+/**
+ * Read the png file into the pixels of the atlas at the position of
+ * the sprite.
+ */
+static void spriteatlas_read_png(const SpriteAtlas::Sprite &sprite,
+                                 std::vector<png_bytep> &rows) {
+  png_structp png_ptr;
+  png_infop info_ptr;
+  std::vector<png_bytep> dst(sprite.height);
+  unsigned int i;
+  FILE* fp = fopen(sprite.path.c_str(), "rb");
+
+  if (fp == NULL)
+    throw new IOException("Error opening sprite image");
+
+  png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+  info_ptr = (png_ptr != NULL) ? png_create_info_struct(png_ptr) : NULL;
+  if (info_ptr == NULL) {
+    png_destroy_read_struct(&png_ptr, NULL, NULL);
+    fclose(fp);
+    throw new IOException("png_create_read_struct failed");
+  }
+  
+  if (setjmp(png_jmpbuf(png_ptr))) {
+    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+    fclose(fp);
+    throw new IOException("Error reading sprite image");
+  }
+
+  png_init_io(png_ptr, fp);
+  png_read_info(png_ptr, info_ptr);
+
+  // convert to 8 bit RGBA
+  png_set_expand(png_ptr);
+  png_set_strip_16(png_ptr);
+  png_set_gray_to_rgb(png_ptr);
+  png_set_add_alpha(png_ptr, 0xFF, PNG_FILLER_AFTER);
+  png_set_interlace_handling(png_ptr);
+  png_read_update_info(png_ptr, info_ptr);
+
+  if (png_get_image_width(png_ptr, info_ptr) != sprite.width ||
+      png_get_image_height(png_ptr, info_ptr) != sprite.height)
+    png_error(png_ptr, "image size changed");
+
+  for (i = 0; i < sprite.height; i++)
+    dst[i] = rows[sprite.y + i] + sprite.x * 4;
+
+  png_read_image(png_ptr, &dst[0]);
+  png_read_end(png_ptr, NULL);
+  png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+  fclose(fp);
+}
+#endif
+
+void SpriteAtlas::write() const {
+#ifdef WITH_LIBPNG
+  std::vector<png_byte> pixels((size_t)width * height * 4, 0);
+  std::vector<png_bytep> rows(height);
+  std::vector<Sprite>::const_iterator s;
+  png_structp png_ptr;
+  png_infop info_ptr;
+  unsigned int i;
+  FILE* fp;
+
+#ifdef WITH_LIBGLOG
+  VLOG(1) << "Writing sprite atlas " << filename << ": " << width << "x" <<
+    height;
+#endif
+  
+  for (i = 0; i < height; i++)
+    rows[i] = &pixels[(size_t)i * width * 4];
+  
+  for (s = sprites.begin(); s != sprites.end(); s++)
+    spriteatlas_read_png(*s, rows);
+
+  if ((fp = fopen(filename.c_str(), "wb")) == NULL)
+    throw new IOException("Error opening sprite atlas file");
+
+  png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+  info_ptr = (png_ptr != NULL) ? png_create_info_struct(png_ptr) : NULL;
+  if (info_ptr == NULL) {
+    png_destroy_write_struct(&png_ptr, NULL);
+    fclose(fp);
+    throw new IOException("png_create_write_struct failed");
+  }
+  if (setjmp(png_jmpbuf(png_ptr))) {
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+    fclose(fp);
+    throw new IOException("Error writing sprite atlas file");
+  }
+
+  png_init_io(png_ptr, fp);
+  png_set_IHDR(png_ptr, info_ptr, width, height, 8,
+               PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE,
+               PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+  png_set_compression_level(png_ptr, 9);
+  png_write_info(png_ptr, info_ptr);
+  png_write_image(png_ptr, &rows[0]);
+  png_write_end(png_ptr, NULL);
+  png_destroy_write_struct(&png_ptr, &info_ptr);
+  
+  if (fclose(fp) != 0)
+    throw new IOException("Error writing sprite atlas file");
+#else
+  throw new IOException("Sprites require libpng.");
+#endif
+}
+
+const std::string& SpriteAtlas::getFilename() const {
+  return filename;
+}
+unsigned int SpriteAtlas::getWidth() const {
+  return width;
+}
+unsigned int SpriteAtlas::getHeight() const {
+  return height;
+}
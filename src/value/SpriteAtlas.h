@@ -0,0 +1,94 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __SpriteAtlas_h__
+#define __SpriteAtlas_h__
+
+#include <string>
+#include <vector>
+#include <map>
+
+/**
+ * An image that combines the images used with sprite() in one group.
+ * Images are placed when they are added, with a shelf packer, so their
+ * positions are known while the stylesheet is processed and only
+ * depend on the order the images are added in. The atlas is written
+ * when the stylesheet is done, with writeAtlases().
+ */
+class SpriteAtlas {
+public:
+  struct Sprite {
+    std::string path;
+    unsigned int x, y, width, height;
+  };
+
+  /**
+   * Shelves are not made wider than this unless an image is wider.
+   */
+  static const unsigned int MAX_WIDTH = 1024;
+
+private:
+  struct Shelf {
+    unsigned int y, height;
+    unsigned int width;
+  };
+
+  std::string filename;
+  std::vector<Sprite> sprites;
+  std::map<std::string, size_t> index;
+  std::vector<Shelf> shelves;
+  unsigned int width, height;
+
+  static std::map<std::string, SpriteAtlas*> atlases;
+
+  SpriteAtlas(const std::string &filename);
+
+  void place(Sprite &sprite);
+  void write() const;
+  
+public:
+  virtual ~SpriteAtlas();
+
+  /**
+   * Returns the atlas that is written to the file, creating it if it
+   * does not exist yet.
+   */
+  static SpriteAtlas& getAtlas(const std::string &filename);
+
+  /**
+   * Write all atlases that have sprites and remove them.
+   */
+  static void writeAtlases();
+
+  /**
+   * Add a png image to the atlas, or return the sprite if it was
+   * already added.
+   *
+   * @return the sprite, or NULL if the file is not a png image.
+   */
+  const Sprite* addSprite(const std::string &path);
+
+  const std::string& getFilename() const;
+  unsigned int getWidth() const;
+  unsigned int getHeight() const;
+};
+
+#endif
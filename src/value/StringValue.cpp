@@ -20,63 +20,61 @@
  */
 
 #include "StringValue.h"
+#include "UrlValue.h"
+#include "DataUri.h"
 
 #include <config.h>
 #ifdef WITH_LIBGLOG
 #include <glog/logging.h>
 #endif
 
+#include <iostream>
+
 
 StringValue::StringValue(const Token &token, bool quotes) {
   type = Value::STRING;
   
   tokens.push_back(token);
+  setLocation(token);
   this->quotes = quotes;
   setString(token);
 }
 
 StringValue::StringValue(const std::string &str, bool quotes) {
-  Token token(str, Token::STRING, 0,0,"generated");
-  
   type = Value::STRING;
-  tokens.push_back(token);
+  tokens.push_back(Token("", Token::STRING, 0,0,"generated"));
   this->quotes = quotes;
-  setString(token);
+  setString(str);
 }
 
 StringValue::StringValue(const StringValue &s) {
-  Token token(s.getString(), Token::STRING, 0,0,"generated");
-
   type = Value::STRING;
-  tokens.push_back(token);
+  tokens.push_back(Token("", Token::STRING, 0,0,"generated"));
   this->quotes = s.getQuotes();
-  setString(token);
+  setString(s.getString());
 }
 
 StringValue::StringValue(const Value &val, bool quotes) {
   const StringValue* sval;
-  Token token = val.getTokens()->front();
-  token.type = Token::STRING;
-  
-  if (val.type == STRING) {
-    sval = static_cast<const StringValue*>(&val);
-    token = sval->getString();
-  } else {
-    token = val.getTokens()->toString();
-  }
 
   type = Value::STRING;
-  tokens.push_back(token);
+  tokens.push_back(Token("", Token::STRING, 0,0,"generated"));
+  setLocation(val);
   this->quotes = quotes;
-  setString(token);
+  
+  if (val.type == STRING) {
+    sval = static_cast<const StringValue*>(&val);
+    setString(sval->getString());
+  } else
+    setString(val.getTokens()->toString());
 }
 
 StringValue::~StringValue() {
 }
 
 
-void StringValue::updateTokens() {
-  std::string::iterator i;
+void StringValue::updateTokens() const {
+  std::string::const_iterator i;
   std::string newstr;
 
   if (quotes) {
@@ -88,23 +86,22 @@ void StringValue::updateTokens() {
       newstr.push_back(*i);
     }
     newstr.push_back('"');
-    tokens.front() = newstr;
+    tokens.front().assign(newstr);
   } else
-    tokens.front() = strvalue;
+    tokens.front().assign(strvalue);
 }
 
 std::string StringValue::getString() const {
   return strvalue;
 }
 void StringValue::setString(const std::string &newValue) {
-  std::string s = newValue;
-  this->strvalue = s;
-  updateTokens();
+  strvalue = newValue;
+  setModified();
 }
   
 void StringValue::setQuotes(bool quotes) {
   this->quotes = quotes;
-  updateTokens();
+  setModified();
 }
 bool StringValue::getQuotes() const {
   return quotes;
@@ -120,7 +117,7 @@ void StringValue::append(const Value &v) {
     strvalue.append(v.getTokens()->toString());
   }
 
-  updateTokens();
+  setModified();
 }
 
 
@@ -266,12 +263,61 @@ placeholders for all given arguments.", *arguments[0]->getTokens());
 Value* StringValue::color(const vector<const Value*> &arguments) {
   const StringValue* s;
   Token t;
+  Color* c;
   
   s = static_cast<const StringValue*>(arguments[0]);
 
-  t = Token(s->getString(), Token::HASH ,0,0,"generated");
+  t = Token(s->getString(), Token::IDENTIFIER, 0, 0, "generated");
+  if ((c = Color::fromName(t)) != NULL)
+    return c;
+  
+  t.type = Token::HASH;
   return new Color(t);
 }
 Value* StringValue::data_uri(const vector<const Value*> &arguments) {
-  return new StringValue(*(const StringValue*)arguments[0]);
+  const StringValue* file = (const StringValue*)arguments.back();
+  std::string mimetype, path = file->getString(), fragment, uri;
+  size_t pos;
+  Token token = file->getTokens()->front();
+
+  if (arguments.size() > 1)
+    mimetype = ((const StringValue*)arguments[0])->getString();
+
+  // the fragment is kept for svg files, 'icons.svg#icon'
+  if ((pos = path.find('#')) != std::string::npos) {
+    fragment = path.substr(pos);
+    path.erase(pos);
+  }
+
+  switch (DataUri::getInstance().getUri(UrlValue::getRelativePath(token.source,
+                                                                   path),
+                                        mimetype, uri)) {
+  case DataUri::NOT_FOUND:
+    throw new ValueException("data-uri(): file '" + path +
+                             "' could not be read.", *file->getTokens());
+    
+  case DataUri::TOO_LARGE:
+#ifdef WITH_LIBGLOG
+    LOG(WARNING) << token.source << ": Line " << token.line << ", Column " <<
+      token.column << " Warning: Not inlining " << path <<
+      " with data-uri() because it is " <<
+      DataUri::getInstance().getMaxSize() / 1024 << "KB or larger.";
+#else
+    std::cerr << token.source << ": Line " << token.line << ", Column " <<
+      token.column << " Warning: Not inlining " << path <<
+      " with data-uri() because it is " <<
+      DataUri::getInstance().getMaxSize() / 1024 << "KB or larger." <<
+      std::endl;
+#endif
+    uri = file->getString();
+    break;
+
+  case DataUri::OK:
+    uri.append(fragment);
+    break;
+  }
+
+  token.assign("url(\"" + uri + "\")");
+  token.type = Token::URL;
+  return new UrlValue(token, uri);
 }
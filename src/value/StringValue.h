@@ -34,7 +34,8 @@ private:
   std::string strvalue;
   bool quotes;
 
-  void updateTokens();
+protected:
+  virtual void updateTokens() const;
 
 public:
   StringValue(const Token &token, bool quotes);
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "UnitRegistry.h"
+
+#define PI 3.141592653589793
+
+/**
+ * The canonical units are px, ms, Hz, rad and dppx.
+ */
+const UnitRegistry::UnitDefinition UnitRegistry::UNITS[] = {
+  {"", UNKNOWN_UNIT, NO_GROUP, 0},
+
+  {"px", PX, LENGTH, 1},
+  {"m", M, LENGTH, 96 / .0254},
+  {"cm", CM, LENGTH, 96 / 2.54},
+  {"mm", MM, LENGTH, 96 / 25.4},
+  {"Q", Q, LENGTH, 96 / 101.6},
+  {"in", IN, LENGTH, 96},
+  {"pt", PT, LENGTH, 4.0 / 3.0},
+  {"pc", PC, LENGTH, 16},
+
+  {"em", EM, NO_GROUP, 0},
+  {"ex", EX, NO_GROUP, 0},
+  {"ch", CH, NO_GROUP, 0},
+  {"rem", REM, NO_GROUP, 0},
+  {"vw", VW, NO_GROUP, 0},
+  {"vh", VH, NO_GROUP, 0},
+  {"vmin", VMIN, NO_GROUP, 0},
+  {"vmax", VMAX, NO_GROUP, 0},
+
+  {"s", S, TIME, 1000},
+  {"ms", MS, TIME, 1},
+
+  {"Hz", HZ, FREQUENCY, 1},
+  {"kHz", KHZ, FREQUENCY, 1000},
+
+  {"rad", RAD, ANGLE, 1},
+  {"deg", DEG, ANGLE, PI / 180},
+  {"grad", GRAD, ANGLE, PI / 200},
+  {"turn", TURN, ANGLE, 2 * PI},
+
+  {"dppx", DPPX, RESOLUTION, 1},
+  {"x", X, RESOLUTION, 1},
+  {"dpi", DPI, RESOLUTION, 1 / 96.0},
+  {"dpcm", DPCM, RESOLUTION, 2.54 / 96}
+};
+
+static_assert(sizeof(UnitRegistry::UNITS) /
+              sizeof(UnitRegistry::UNITS[0]) == UnitRegistry::UNIT_COUNT,
+              "UNITS needs an entry for every unit");
+
+/**
+ * Returns the first of the candidates that is named name.
+ */
+static UnitRegistry::Unit matchUnit(const std::string &name,
+                                    UnitRegistry::Unit a,
+                                    UnitRegistry::Unit b =
+                                    UnitRegistry::UNKNOWN_UNIT,
+                                    UnitRegistry::Unit c =
+                                    UnitRegistry::UNKNOWN_UNIT,
+                                    UnitRegistry::Unit d =
+                                    UnitRegistry::UNKNOWN_UNIT) {
+  if (name == UnitRegistry::UNITS[a].name)
+    return a;
+  if (b != UnitRegistry::UNKNOWN_UNIT && name == UnitRegistry::UNITS[b].name)
+    return b;
+  if (c != UnitRegistry::UNKNOWN_UNIT && name == UnitRegistry::UNITS[c].name)
+    return c;
+  if (d != UnitRegistry::UNKNOWN_UNIT && name == UnitRegistry::UNITS[d].name)
+    return d;
+  return UnitRegistry::UNKNOWN_UNIT;
+}
+
+UnitRegistry::Unit UnitRegistry::findUnit(const std::string &name) {
+  if (name.empty() || name.size() > 4)
+    return UNKNOWN_UNIT;
+
+  // The first character leaves at most four candidates.
+  switch (name[0]) {
+  case 'p':
+    return matchUnit(name, PX, PT, PC);
+  case 'm':
+    return matchUnit(name, M, MM, MS);
+  case 'c':
+    return matchUnit(name, CM, CH);
+  case 'Q':
+    return matchUnit(name, Q);
+  case 'i':
+    return matchUnit(name, IN);
+  case 'e':
+    return matchUnit(name, EM, EX);
+  case 'r':
+    return matchUnit(name, REM, RAD);
+  case 'v':
+    return matchUnit(name, VW, VH, VMIN, VMAX);
+  case 's':
+    return matchUnit(name, S);
+  case 'H':
+    return matchUnit(name, HZ);
+  case 'k':
+    return matchUnit(name, KHZ);
+  case 'd':
+    return matchUnit(name, DEG, DPPX, DPI, DPCM);
+  case 'g':
+    return matchUnit(name, GRAD);
+  case 't':
+    return matchUnit(name, TURN);
+  case 'x':
+    return matchUnit(name, X);
+  }
+  return UNKNOWN_UNIT;
+}
+
+UnitRegistry::UnitGroup UnitRegistry::getUnitGroup(Unit unit) {
+  return UNITS[unit].group;
+}
+
+const char* UnitRegistry::getName(Unit unit) {
+  return UNITS[unit].name;
+}
+
+bool UnitRegistry::convert(double &value, Unit from, Unit to) {
+  if (from == to)
+    return true;
+
+  if (UNITS[from].group == NO_GROUP ||
+      UNITS[from].group != UNITS[to].group)
+    return false;
+
+  value = value * UNITS[from].factor / UNITS[to].factor;
+  return true;
+}
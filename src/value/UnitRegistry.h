@@ -0,0 +1,80 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>. 
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#ifndef __UnitRegistry_h__
+#define __UnitRegistry_h__
+
+#include <string>
+
+/**
+ * Table of the CSS units with the factors that convert between units
+ * of the same group.
+ */
+class UnitRegistry {
+public:
+  enum UnitGroup {NO_GROUP, LENGTH, TIME, ANGLE, FREQUENCY, RESOLUTION};
+
+  /**
+   * Relative units (em, rem, vw, ...) are in NO_GROUP and can only be
+   * used with the same unit.
+   */
+  enum Unit {UNKNOWN_UNIT,
+             PX, M, CM, MM, Q, IN, PT, PC,
+             EM, EX, CH, REM, VW, VH, VMIN, VMAX,
+             S, MS,
+             HZ, KHZ,
+             RAD, DEG, GRAD, TURN,
+             DPPX, X, DPI, DPCM,
+             UNIT_COUNT};
+
+  struct UnitDefinition {
+    const char* name;
+    Unit unit;
+    UnitGroup group;
+    /**
+     * Converts the unit to the canonical unit of its group.
+     */
+    double factor;
+  };
+
+  /**
+   * Indexed by Unit.
+   */
+  static const UnitDefinition UNITS[];
+  
+  /**
+   * Look up a unit by name.
+   *
+   * @return the unit or UNKNOWN_UNIT if the name is not a known unit.
+   */
+  static Unit findUnit(const std::string &name);
+  static UnitGroup getUnitGroup(Unit unit);
+  static const char* getName(Unit unit);
+
+  /**
+   * Convert value from one unit to another unit in the same group.
+   *
+   * @return false if the units can not be converted into each other.
+   */
+  static bool convert(double &value, Unit from, Unit to);
+};
+
+#endif
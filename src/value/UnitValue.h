@@ -27,12 +27,10 @@
 #include "StringValue.h"
 
 /**
- * A dimension unit: em,ex,px,ch,in,cm,mm,pt,pc
+ * A dimension unit that is known to UnitRegistry: px, em, ms, deg, etc.
  */
 class UnitValue: public Value {
 public:
-  enum UnitGroup {NO_GROUP, LENGTH, TIME, ANGLE};
-  
   UnitValue(Token &token);
   virtual ~UnitValue();
 
@@ -45,16 +43,6 @@ public:
 
   virtual BooleanValue* lessThan(const Value &v) const;
   virtual BooleanValue* equals(const Value &v) const;
-
-  static UnitGroup getUnitGroup(const std::string &unit);
-  static double lengthToPx(const double length, const std::string &unit);
-  static double pxToLength(double px, const std::string &unit);
-  
-  static double timeToMs(double time, const std::string &unit);
-  static double msToTime(double ms, const std::string &unit);
-  
-  static double angleToRad(double angle, const std::string &unit);
-  static double radToAngle(double rad, const std::string &unit);
 };
 
 #endif
@@ -20,6 +20,10 @@
  */
 
 #include "UrlValue.h"
+#include "ImageCache.h"
+#include "ImageProbe.h"
+#include "SpriteAtlas.h"
+#include "StringValue.h"
 
 #include <config.h>
 
@@ -28,10 +32,6 @@
 #endif
 
 
-#ifdef WITH_LIBPNG
-#include <png.h>
-#endif
-
 #ifdef WITH_LIBJPEG
 #include <jpeglib.h>
 #include <setjmp.h>
@@ -62,6 +62,9 @@ urlvalue_jpeg_error_exit (j_common_ptr cinfo)
 #endif
 
 UrlValue_Img::UrlValue_Img() {
+  width = 0;
+  height = 0;
+  hasBackground = false;
 }
 
 UrlValue::UrlValue(Token &token, std::string &path): Value() {
@@ -79,7 +82,12 @@ std::string UrlValue::getPath() const {
 }
 
 std::string UrlValue::getRelativePath() const {
-  std::string source = tokens.front().source;
+  return getRelativePath(tokens.front().source, path);
+}
+
+std::string UrlValue::getRelativePath(const char* sourcefile,
+                                      const std::string &path) {
+  std::string source = sourcefile;
   size_t pos = source.find_last_of("/\\");
   std::string relative_path;
   
@@ -87,9 +95,9 @@ std::string UrlValue::getRelativePath() const {
   //  then add its directory to the path.
   if (pos != std::string::npos) {
     relative_path.append(source.substr(0, pos + 1));
-    relative_path.append(this->path);
+    relative_path.append(path);
   } else
-    relative_path = this->path;
+    relative_path = path;
   return relative_path;
 }
 
@@ -136,104 +144,28 @@ BooleanValue* UrlValue::equals(const Value &v) const {
   }
 }
 
-bool UrlValue::loadImg(UrlValue_Img &img) const {
-  return loadPng(img) || loadJpeg(img);
-}
-
-bool UrlValue::loadPng(UrlValue_Img &img) const {
-
-#ifdef WITH_LIBPNG
-  unsigned char header[8];    // 8 is the maximum size that can be checked
-  /* open file and test for it being a png */
-  
-  png_structp png_ptr;
-  png_infop info_ptr;
-  png_byte color_type;
-  int channels;
-  
-  std::string path = getRelativePath();
-  
-#ifdef WITH_LIBGLOG
-  VLOG(3) << "PNG path: " << path;
-#endif
-    
-  FILE *fp = fopen(path.c_str(), "rb");
-  if (!fp)
-    return false; //"Image file could not be opened"
-
-  fread(header, 1, 8, fp);
-  
-  if (png_sig_cmp(header, 0, 8))
-    return false; //"Image is not a PNG file"
-
-  /* initialize stuff */
-  png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+bool UrlValue::loadImg(UrlValue_Img &img, bool background) const {
+  ImageCache::Entry* entry =
+    ImageCache::getInstance().getEntry(getRelativePath());
 
-  if (!png_ptr)
-    throw new ValueException("png_create_read_struct failed",
-                             *this->getTokens());
-
-  info_ptr = png_create_info_struct(png_ptr);
-  if (!info_ptr)
-    throw new ValueException("png_create_info_struct failed",
-                             *this->getTokens());
-
-  if (setjmp(png_jmpbuf(png_ptr)))
-    throw new ValueException("Error during init_io",
-                             *this->getTokens());
-
-  png_init_io(png_ptr, fp);
-  png_set_sig_bytes(png_ptr, 8);
-
-  png_read_info(png_ptr, info_ptr);
+  if (entry == NULL)
+    return false;
 
-  img.width = png_get_image_width(png_ptr, info_ptr);
-  img.height = png_get_image_height(png_ptr, info_ptr);
-  channels = png_get_channels(png_ptr, info_ptr);
-  color_type = png_get_color_type(png_ptr, info_ptr);
-  
-  if(color_type == PNG_COLOR_TYPE_PALETTE) {
-    png_set_palette_to_rgb(png_ptr);
-    channels = 3;
-  }
-  if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) {
-    png_set_tRNS_to_alpha(png_ptr);
-    channels += 1;
+  if (!entry->loaded) {
+    entry->found = (ImageProbe::probe(getRelativePath(), entry->img) !=
+                    ImageProbe::NONE);
+    entry->loaded = true;
   }
-
-#ifdef WITH_LIBGLOG
-  VLOG(3) << "Width: " << img.width << ", Height: " << img.height <<
-    ", Channels: " << channels;
-#endif
-
-  png_color_16p pBackground;
-  if (png_get_valid(png_ptr, info_ptr, PNG_INFO_bKGD)) {
-    png_get_bKGD(png_ptr, info_ptr, &pBackground);
-    img.background.setRGB(pBackground->red,
-                          pBackground->green,
-                          pBackground->blue);
-  }else {
-    img.background.setRGB(255,255,255);
+  if (background && entry->found && !entry->img.hasBackground) {
+    if (!loadJpegBackground(entry->img))
+      entry->img.background.setRGB(0, 0, 0);
+    entry->img.hasBackground = true;
   }
-
-  png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-  png_ptr = NULL;
-  info_ptr = NULL;
-  fclose(fp);
-  
-#ifdef WITH_LIBGLOG
-  VLOG(3) << "Read successful";
-#endif
-
-  return true;
-  
-#else
-  return false;
-#endif  
+  img = entry->img;
+  return entry->found;
 }
 
-
-bool UrlValue::loadJpeg(UrlValue_Img &img) const {
+bool UrlValue::loadJpegBackground(UrlValue_Img &img) const {
 #ifdef WITH_LIBJPEG
   struct jpeg_decompress_struct cinfo;
   
@@ -291,8 +223,7 @@ bool UrlValue::loadJpeg(UrlValue_Img &img) const {
    * with the stdio data source.
    */
 
-  img.width = cinfo.output_width;
-  img.height = cinfo.output_height;
+  img.background.setRGB(0, 0, 0);
   
   /* We may need to do some setup of our own at this point before reading
    * the data. After jpeg_start_decompress() we have the correct scaled
@@ -374,7 +305,7 @@ unsigned int UrlValue::getImageHeight() const {
 
 Color UrlValue::getImageBackground() const {
   UrlValue_Img img;
-  loadImg(img);
+  loadImg(img, true);
   return img.background;
 }
 
@@ -383,6 +314,11 @@ void UrlValue::loadFunctions(FunctionLibrary &lib) {
   lib.push("imgheight", "R", &UrlValue::imgheight);
   lib.push("imgwidth", "R", &UrlValue::imgwidth);
   lib.push("imgbackground", "R", &UrlValue::imgbackground);
+  lib.push("sprite", "SR", &UrlValue::sprite);
+  lib.push("sprite-position", "SR", &UrlValue::sprite_position);
+  lib.push("sprite-width", "SR", &UrlValue::sprite_width);
+  lib.push("sprite-height", "SR", &UrlValue::sprite_height);
+  lib.push("sprite-url", "S", &UrlValue::sprite_url);
 }
 
 
@@ -414,3 +350,77 @@ Value* UrlValue::imgbackground(const vector<const Value*> &arguments) {
   const UrlValue* u = static_cast<const UrlValue*>(arguments[0]);
   return new Color(u->getImageBackground());
 }
+
+const SpriteAtlas::Sprite* UrlValue::getSprite(const vector<const Value*>
+                                               &arguments) {
+  const StringValue* group = static_cast<const StringValue*>(arguments[0]);
+  const UrlValue* u = static_cast<const UrlValue*>(arguments[1]);
+  const SpriteAtlas::Sprite* sprite;
+  
+#ifndef WITH_LIBPNG
+  throw new ValueException("sprite functions are not supported: lessc \
+has to be compiled with libpng.", *u->getTokens());
+#endif
+
+  SpriteAtlas &atlas =
+    SpriteAtlas::getAtlas(getRelativePath(group->getTokens()->front().source,
+                                          group->getString()));
+  
+  if ((sprite = atlas.addSprite(u->getRelativePath())) == NULL) {
+    throw new ValueException("Sprite images have to be png files.",
+                             *u->getTokens());
+  }
+  return sprite;
+}
+
+Token UrlValue::getSpriteOffset(unsigned int offset, const Token &reference) {
+  std::ostringstream str;
+  
+  if (offset == 0)
+    return Token("0", Token::NUMBER, reference.line, reference.column,
+                 reference.source);
+  str << "-" << offset << "px";
+  return Token(str.str(), Token::DIMENSION, reference.line,
+               reference.column, reference.source);
+}
+
+Value* UrlValue::sprite(const vector<const Value*> &arguments) {
+  const SpriteAtlas::Sprite* s = getSprite(arguments);
+  UrlValue* u = static_cast<UrlValue*>(sprite_url(arguments));
+  Token reference = u->tokens.front();
+
+  // url("atlas.png") -Xpx -Ypx
+  u->tokens.push_back(Token::BUILTIN_SPACE);
+  u->tokens.push_back(getSpriteOffset(s->x, reference));
+  u->tokens.push_back(Token::BUILTIN_SPACE);
+  u->tokens.push_back(getSpriteOffset(s->y, reference));
+  return u;
+}
+
+Value* UrlValue::sprite_position(const vector<const Value*> &arguments) {
+  const SpriteAtlas::Sprite* s = getSprite(arguments);
+  const Token &reference = arguments[1]->getTokens()->front();
+
+  return new StringValue(getSpriteOffset(s->x, reference) + " " +
+                         getSpriteOffset(s->y, reference), false);
+}
+
+Value* UrlValue::sprite_width(const vector<const Value*> &arguments) {
+  std::string px = "px";
+  return new NumberValue(getSprite(arguments)->width, Token::DIMENSION, &px);
+}
+
+Value* UrlValue::sprite_height(const vector<const Value*> &arguments) {
+  std::string px = "px";
+  return new NumberValue(getSprite(arguments)->height, Token::DIMENSION, &px);
+}
+
+Value* UrlValue::sprite_url(const vector<const Value*> &arguments) {
+  const StringValue* group = static_cast<const StringValue*>(arguments[0]);
+  std::string path = group->getString();
+  Token token = group->getTokens()->front();
+
+  token.assign("url(\"" + path + "\")");
+  token.type = Token::URL;
+  return new UrlValue(token, path);
+}
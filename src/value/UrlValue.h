@@ -24,6 +24,7 @@
 
 #include "Value.h"
 #include "Color.h"
+#include "SpriteAtlas.h"
 #include <string>
 
 class UrlValue_Img {
@@ -31,6 +32,10 @@ public:
   unsigned int width;
   unsigned int height;
   Color background;
+  /**
+   * False if the background has to be read from the pixels.
+   */
+  bool hasBackground;
 
   UrlValue_Img();
 };
@@ -40,9 +45,27 @@ private:
 
   std::string path;
 
-  bool loadImg(UrlValue_Img &img) const;
-  bool loadPng(UrlValue_Img &img) const;
-  bool loadJpeg(UrlValue_Img &img) const;
+  /**
+   * Read the size of the image from the image cache, or from the
+   * header of the file. With background set, the background color is
+   * also read from the pixels if the header does not have one.
+   */
+  bool loadImg(UrlValue_Img &img, bool background = false) const;
+  /**
+   * Decode a jpeg file to find the color of its corners.
+   */
+  bool loadJpegBackground(UrlValue_Img &img) const;
+
+  /**
+   * Add the url in the second argument to the sprite atlas named by
+   * the first argument.
+   */
+  static const SpriteAtlas::Sprite* getSprite(const vector<const Value*>
+                                              &arguments);
+  /**
+   * A background position offset: '0' or '-10px'.
+   */
+  static Token getSpriteOffset(unsigned int offset, const Token &reference);
 
 public:
   UrlValue(Token &token, std::string &path);
@@ -52,6 +75,11 @@ public:
   std::string getPath() const;
 
   std::string getRelativePath() const;
+  /**
+   * Returns the path relative to the directory of the source file.
+   */
+  static std::string getRelativePath(const char* source,
+                                     const std::string &path);
   
   virtual Value* add(const Value &v) const;
   virtual Value* substract(const Value &v) const;
@@ -70,6 +98,12 @@ public:
   static Value* imgheight(const vector<const Value*> &arguments);
   static Value* imgwidth(const vector<const Value*> &arguments);
   static Value* imgbackground(const vector<const Value*> &arguments);
+
+  static Value* sprite(const vector<const Value*> &arguments);
+  static Value* sprite_position(const vector<const Value*> &arguments);
+  static Value* sprite_width(const vector<const Value*> &arguments);
+  static Value* sprite_height(const vector<const Value*> &arguments);
+  static Value* sprite_url(const vector<const Value*> &arguments);
 };
   
 #endif
@@ -22,17 +22,54 @@
 #include "Value.h"
 #include "BooleanValue.h"
 
-Value::Value() {
+Value::Value(): modified(false), line(0), column(0),
+                source("generated") {
 }
 
 Value::~Value() {
 }
 
+void Value::setModified() {
+  modified = true;
+}
+bool Value::isModified() const {
+  return modified;
+}
+
+void Value::updateTokens() const {
+}
+
 void Value::setLocation(const Token& ref) {
-  tokens.front().setLocation(ref);
+  line = ref.line;
+  column = ref.column;
+  source = ref.source;
+  
+  if (!modified && !tokens.empty())
+    tokens.front().setLocation(ref);
+}
+void Value::setLocation(const Value& ref) {
+  line = ref.line;
+  column = ref.column;
+  source = ref.source;
+
+  if (!modified && !tokens.empty()) {
+    tokens.front().line = line;
+    tokens.front().column = column;
+    tokens.front().source = source;
+  }
 }
   
 const TokenList* Value::getTokens() const{
+  if (modified) {
+    updateTokens();
+    modified = false;
+
+    if (!tokens.empty()) {
+      tokens.front().line = line;
+      tokens.front().column = column;
+      tokens.front().source = source;
+    }
+  }
   return &tokens;
 }
 
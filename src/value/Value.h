@@ -32,19 +32,42 @@ class BooleanValue;
  * 
  */
 class Value {
+private:
+  mutable bool modified;
+  
 protected:
-  TokenList tokens;
+  mutable TokenList tokens;
+
+  /**
+   * The source location of the value, given to the first token.
+   */
+  unsigned int line, column;
+  const char* source;
+
+  /**
+   * Mark the tokens as out of date. They are rendered with
+   * updateTokens() the next time getTokens() is called, so
+   * intermediate results of a calculation are never formatted.
+   */
+  void setModified();
+  bool isModified() const;
+
+  /**
+   * Replace the tokens with a rendering of the current value. Values
+   * that call setModified() have to implement this.
+   */
+  virtual void updateTokens() const;
   
 public:
   enum Type {NUMBER, PERCENTAGE, DIMENSION, COLOR, STRING, UNIT,
              BOOLEAN, URL} type;
   Value();
-  Value(const Token &token);
   virtual ~Value();
 
   void setLocation(const Token& ref);
+  void setLocation(const Value& ref);
   
-  virtual const TokenList* getTokens() const;
+  const TokenList* getTokens() const;
   
   virtual Value* add(const Value &v) const =0;
   virtual Value* substract(const Value &v) const =0;
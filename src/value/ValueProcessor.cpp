@@ -38,22 +38,32 @@ inline std::string to_string (const T& t)
 }
 */
 
-ValueProcessor::ValueProcessor() {
-  NumberValue::loadFunctions(functionLibrary);
-  Color::loadFunctions(functionLibrary);
-  StringValue::loadFunctions(functionLibrary);
-  UrlValue::loadFunctions(functionLibrary);  
+ValueProcessor::ValueProcessor():
+  functionLibrary(getFunctionLibrary()) {
 }
 ValueProcessor::~ValueProcessor() {
 }
 
+const FunctionLibrary& ValueProcessor::getFunctionLibrary() {
+  static FunctionLibrary library;
+  static bool loaded = false;
+
+  if (!loaded) {
+    NumberValue::loadFunctions(library);
+    Color::loadFunctions(library);
+    StringValue::loadFunctions(library);
+    UrlValue::loadFunctions(library);
+    loaded = true;
+  }
+  return library;
+}
+
 void ValueProcessor::processValue(TokenList &value, const ValueScope &scope)
   const {
   TokenList::iterator i;
   TokenList newvalue;
   Value* v;
   const TokenList* var;
-  TokenList variable;
   const TokenList* oldvalue = &value;
   TokenList::const_iterator i2, itmp, end;
   
@@ -101,18 +111,12 @@ void ValueProcessor::processValue(TokenList &value, const ValueScope &scope)
       // variable containing a non-value.
       if ((*i2).type == Token::ATKEYWORD &&
           (var = scope.getVariable(*i2)) != NULL) {
-        variable = *var;
-        processValue(variable, scope);
-        
-        newvalue.insert(newvalue.end(), variable.begin(), variable.end());
+        appendVariable(newvalue, *var, scope);
         i2++;
 
         // deep variable
       } else if ((var = processDeepVariable(i2, end, scope)) != NULL) {
-        variable = *var;
-        processValue(variable, scope);
-
-        newvalue.insert(newvalue.end(), variable.begin(), variable.end());
+        appendVariable(newvalue, *var, scope);
 
       } else if ((*i2).type == Token::IDENTIFIER) {
 
@@ -133,10 +137,62 @@ void ValueProcessor::processValue(TokenList &value, const ValueScope &scope)
   VLOG(2) << "Processed: " << newvalue.toString();
 #endif
   
-  value = newvalue;
+  value.swap(newvalue);
   return;
 }
 
+void ValueProcessor::processValue(SharedTokenList &value,
+                                  const ValueScope &scope) const {
+  const SharedTokenList* var;
+  TokenList processed;
+
+  // a reference to a variable shares the tokens of that variable
+  if (value->size() == 1 &&
+      value->front().type == Token::ATKEYWORD &&
+      (var = scope.getSharedVariable(value->front())) != NULL &&
+      !needsProcessing(**var) &&
+      !needsInterpolation(**var)) {
+    value = *var;
+    return;
+  }
+  
+  if (!needsProcessing(*value) &&
+      !needsInterpolation(*value))
+    return;
+
+  processed = *value;
+  processValue(processed, scope);
+  value.swap(processed);
+}
+
+void ValueProcessor::appendVariable(TokenList &value,
+                                    const TokenList &variable,
+                                    const ValueScope &scope) const {
+  TokenList processed;
+
+  if (!needsProcessing(variable) &&
+      !needsInterpolation(variable)) {
+    value.insert(value.end(), variable.begin(), variable.end());
+    return;
+  }
+  
+  processed = variable;
+  processValue(processed, scope);
+  value.splice(value.end(), processed);
+}
+
+bool ValueProcessor::needsInterpolation(const TokenList &value) const {
+  TokenList::const_iterator i;
+  
+  for(i = value.begin(); i != value.end(); i++) {
+    if ((*i).type == Token::STRING &&
+        !(*i).isPlain() &&
+        (*i).find("@{") != string::npos)
+      return true;
+  }
+  return false;
+}
+
 bool ValueProcessor::needsProcessing(const TokenList &value) const {
   TokenList::const_iterator i;
   const Token* t;
@@ -362,7 +418,6 @@ Value* ValueProcessor::processConstant(TokenList::const_iterator &i,
   Token token;
   Value* ret;
   const TokenList* var;
-  TokenList variable;
   bool hasQuotes;
   std::string str;
   
@@ -389,9 +444,7 @@ Value* ValueProcessor::processConstant(TokenList::const_iterator &i,
 
   case Token::ATKEYWORD:
     if ((var = scope.getVariable(token)) != NULL) {
-      variable = *var;
-
-      ret = processStatement(variable, scope);
+      ret = processStatement(*var, scope);
       
       if (ret != NULL) {
         i++;
@@ -446,6 +499,8 @@ Value* ValueProcessor::processConstant(TokenList::const_iterator &i,
       
     } else if ((ret = processUnit(token)) != NULL) {
       return ret;  
+    } else if ((ret = Color::fromName(token)) != NULL) {
+      return ret;
     } else if (token.compare("true") == 0) {
       return new BooleanValue(token, true);
     } else {
@@ -460,8 +515,7 @@ Value* ValueProcessor::processConstant(TokenList::const_iterator &i,
   }
 
   if ((var = processDeepVariable(i, end, scope)) != NULL) {
-    variable = *var;
-    ret = processStatement(variable, scope);
+    ret = processStatement(*var, scope);
     if (ret != NULL) {
       ret->setLocation(*i);
     }
@@ -689,21 +743,9 @@ Value* ValueProcessor::processEscape (TokenList::const_iterator &i,
 }
 
 UnitValue* ValueProcessor::processUnit(Token &t) const {
-  // em,ex,px,ch,in,mm,cm,pt,pc,ms
-  string units("emexpxchinmmcmptpcms");
-  size_t pos;
-  if (t.size() == 2 &&
-      (pos = units.find(t)) != string::npos &&
-      pos % 2 == 0) {
-    return new UnitValue(t);
-  } else if(t.compare("m") == 0 ||
-            t.compare("s") == 0 ||
-            t.compare("rad") == 0 ||
-            t.compare("deg") == 0 ||
-            t.compare("grad") == 0 ||
-            t.compare("turn") == 0) {
+  if (UnitRegistry::findUnit(t) != UnitRegistry::UNKNOWN_UNIT)
     return new UnitValue(t);
-  } else
+  else
     return NULL;
 }
 
@@ -771,32 +813,61 @@ Value* ValueProcessor::processNegative(TokenList::const_iterator &i,
   return ret;
 }
 
+const InterpolationTemplate* ValueProcessor::getTemplate(const std::string
+                                                         &str) const {
+  std::map<std::string, InterpolationTemplate>::iterator i;
+
+  i = templates.find(str);
+  if (i == templates.end()) {
+    if (templates.size() >= TEMPLATE_CACHE_SIZE)
+      return NULL;
+    
+    i = templates.insert(std::pair<std::string, InterpolationTemplate>
+                         (str, InterpolationTemplate(str))).first;
+  }
+  return &i->second;
+}
+
 void ValueProcessor::interpolate(std::string &str, const ValueScope &scope)
   const {
-  size_t start, end = 0;
-  string key , value;
-  const TokenList* var;
-  TokenList variable;
+  const InterpolationTemplate* t;
+  string result;
+
+  if (str.find("@{") == string::npos)
+    return;
 
 #ifdef WITH_LIBGLOG
   VLOG(3) << "Interpolate: " << str;
 #endif
 
-  while ((start = str.find("@{", end)) != string::npos &&
-         (end = str.find("}", start)) != string::npos) {
-    key = "@";
-    key.append(str.substr(start + 2, end - (start + 2)));
+  t = getTemplate(str);
+  if (t != NULL)
+    interpolate(*t, scope, result);
+  else
+    interpolate(InterpolationTemplate(str), scope, result);
+  str = result;
+}
 
+void ValueProcessor::interpolate(const InterpolationTemplate &t,
+                                 const ValueScope &scope,
+                                 std::string &result) const {
+  const TokenList* var;
+  TokenList variable;
+  size_t i;
+
+  result = t.getLiteral(0);
+
+  for (i = 0; i < t.getVariableCount(); i++) {
+    
 #ifdef WITH_LIBGLOG
-    VLOG(3) << "Key: " << key;
+    VLOG(3) << "Key: " << t.getVariable(i);
 #endif
     
-    var = scope.getVariable(key);
+    var = scope.getVariable(t.getVariable(i));
     
     if (var != NULL) {
-      variable = *var;
-
-      processValue(variable, scope);
+      variable.clear();
+      appendVariable(variable, *var, scope);
 
       // Remove quotes off strings.
       if (variable.size() == 1 &&
@@ -804,14 +875,22 @@ void ValueProcessor::interpolate(std::string &str, const ValueScope &scope)
         variable.front().removeQuotes();
       }
 
-      value = variable.toString();
-      
-      str.replace(start, (end + 1) - start, value);
-      end = start + value.length();
+      result.append(variable.toString());
+    } else {
+      result.append("@{");
+      result.append(t.getVariable(i), 1, string::npos);
+      result.append("}");
     }
+    result.append(t.getLiteral(i + 1));
   }
 }
 
+void ValueProcessor::interpolate(Token &token, const ValueScope &scope)
+  const {
+  if (!token.isPlain())
+    interpolate((std::string&)token, scope);
+}
+
 void ValueProcessor::interpolate(TokenList &tokens,
                                  const ValueScope &scope) const {
   TokenList::iterator i;
@@ -30,10 +30,12 @@
 #include "NumberValue.h"
 #include "StringValue.h"
 #include "UnitValue.h"
+#include "UnitRegistry.h"
 #include "UrlValue.h"
 #include "ValueException.h"
 #include "ValueScope.h"
 #include "FunctionLibrary.h"
+#include "InterpolationTemplate.h"
 #include <map>
 #include <vector>
 #include <cstring>
@@ -42,7 +44,30 @@
  */
 class ValueProcessor {
 private:
-  FunctionLibrary functionLibrary;
+  const FunctionLibrary &functionLibrary;
+
+  /**
+   * The functions are the same for every processor, so they are
+   * loaded once and shared.
+   */
+  static const FunctionLibrary& getFunctionLibrary();
+
+  /**
+   * Compiled templates of the strings that contain '@{variable}'
+   * references, by string. At most TEMPLATE_CACHE_SIZE templates are
+   * kept; strings that come after that are compiled every time.
+   */
+  mutable std::map<std::string, InterpolationTemplate> templates;
+  static const size_t TEMPLATE_CACHE_SIZE = 4096;
+
+  /**
+   * The cached template of str, or NULL if it is not cached and the
+   * cache is full.
+   */
+  const InterpolationTemplate* getTemplate(const std::string &str) const;
+  void interpolate(const InterpolationTemplate &t,
+                   const ValueScope &scope,
+                   std::string &result) const;
 
   Value* processStatement(const TokenList& tokens,
                           const ValueScope& scope) const;
@@ -92,6 +117,13 @@ private:
 
   void skipWhitespace(TokenList::const_iterator &i,
                       TokenList::const_iterator &end) const;
+
+  /**
+   * Append the processed tokens of a variable to value. The variable
+   * is only copied if it has to be processed.
+   */
+  void appendVariable(TokenList &value, const TokenList &variable,
+                      const ValueScope &scope) const;
 public:
   ValueProcessor();
   virtual ~ValueProcessor();
@@ -105,8 +137,22 @@ public:
    */
   bool needsProcessing(const TokenList &value) const;
 
+  /**
+   * @return  true if value contains a string with variable
+   *          interpolation.
+   */
+  bool needsInterpolation(const TokenList &value) const;
+
   void processValue(TokenList &value, const ValueScope &scope) const;
 
+  /**
+   * Process a shared value. The shared tokens are never modified; the
+   * reference is replaced with the processed value, or with the tokens
+   * of a variable when the value is a single variable that needs no
+   * processing.
+   */
+  void processValue(SharedTokenList &value, const ValueScope &scope) const;
+
   bool validateCondition(const TokenList &value, const ValueScope &scope);
   bool validateValue(TokenList::const_iterator &i,
                      TokenList::const_iterator &end,
@@ -115,6 +161,11 @@ public:
   bool functionExists(const char* function) const;
 
   void interpolate(string &str, const ValueScope &scope) const;
+
+  /**
+   * Interpolate the token unless it is marked as plain.
+   */
+  void interpolate(Token &token, const ValueScope &scope) const;
   void interpolate(TokenList &tokens, const ValueScope &scope) const;
 };
 
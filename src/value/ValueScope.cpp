@@ -27,11 +27,11 @@
 #endif
 
 ValueScope::ValueScope(const ValueScope &p,
-                       const std::map<std::string, TokenList> &v):
+                       const std::map<std::string, SharedTokenList> &v):
   parent(&p), variables(&v){
 }
 
-ValueScope::ValueScope(const std::map<std::string, TokenList> &v):
+ValueScope::ValueScope(const std::map<std::string, SharedTokenList> &v):
   parent(NULL), variables(&v) {
 }
 
@@ -41,16 +41,23 @@ void ValueScope::putVariable(const std::string &key, const TokenList &value) {
 }
 */
 const TokenList* ValueScope::getVariable(const std::string &key) const {
-  std::map<std::string, TokenList>::const_iterator mit;
-  
-  mit = variables->find(key);
+  const SharedTokenList* var = getSharedVariable(key);
+
+  return (var != NULL) ? &(**var) : NULL;
+}
+
+const SharedTokenList* ValueScope::getSharedVariable(const std::string &key)
+  const {
+  std::map<std::string, SharedTokenList>::const_iterator mit;
+  const ValueScope* scope;
+
+  for (scope = this; scope != NULL; scope = scope->getParent()) {
+    mit = scope->variables->find(key);
   
-  if (mit != variables->end()) 
-    return &mit->second;
-  else if (getParent() != NULL)
-    return getParent()->getVariable(key);
-  else
-    return NULL;
+    if (mit != scope->variables->end()) 
+      return &mit->second;
+  }
+  return NULL;
 }
 
 const ValueScope* ValueScope::getParent() const {
@@ -27,19 +27,28 @@
 #include <list>
 
 #include "../TokenList.h"
+#include "../SharedTokenList.h"
 
 class ValueScope {
 private:
   const ValueScope* parent;
-  const std::map<std::string, TokenList>* variables;
+  const std::map<std::string, SharedTokenList>* variables;
 
   //void putVariable(const std::string &key, const TokenList &value);
   
 public:
-  ValueScope(const ValueScope &p, const std::map<std::string, TokenList> &v);
-  ValueScope(const std::map<std::string, TokenList> &v);
+  ValueScope(const ValueScope &p,
+             const std::map<std::string, SharedTokenList> &v);
+  ValueScope(const std::map<std::string, SharedTokenList> &v);
   
   const TokenList* getVariable(const std::string &key) const;
+
+  /**
+   * Look up a variable in this scope and its parents, returning the
+   * shared token list so it can be passed on without copying the
+   * tokens.
+   */
+  const SharedTokenList* getSharedVariable(const std::string &key) const;
   
   const ValueScope* getParent() const;
 };
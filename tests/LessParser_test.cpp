@@ -19,136 +19,163 @@
  * Author: Bram van der Kroef <bram@vanderkroef.net>
  */
 
-#include "LessParser.h"
+#include "less/LessParser.h"
+#include "lessstylesheet/LessStylesheet.h"
+#include "lessstylesheet/ProcessingContext.h"
+#include "stylesheet/Stylesheet.h"
 #include "gtest/gtest.h"
 
+#include <sstream>
+
+using namespace std;
+
 TEST(LessParserTest, Variable) {
   istringstream in("@x: 10; selector {key: @x}");
 
-  ValueProcessor vp;
-  ParameterRulesetLibrary pr(&vp);
-
-  LessTokenizer t(&in);
-  LessParser p(&t, &pr, &vp);
+  SourceList sources;
+  LessTokenizer t(in, "test");
+  LessParser p(t, sources);
+  LessStylesheet less;
+  ProcessingContext context;
   Stylesheet s;
   Declaration* d;
   
-  p.parseStylesheet(&s);
+  sources.addSource("test");
+  p.parseStylesheet(less);
+  less.process(s, context);
 
-  ASSERT_EQ((uint)1, s.getRulesets()->size());
-  ASSERT_EQ((uint)1, s.getRulesets()->at(0)->getDeclarations()->size());
+  ASSERT_EQ(1U, s.getRulesets().size());
+  ASSERT_EQ(1U, s.getRulesets().front()->getDeclarations().size());
 
-  d = s.getRulesets()->at(0)->getDeclarations()->at(0);
-  EXPECT_STREQ("key", d->getProperty()->c_str());
-  EXPECT_STREQ("10", d->getValue()->toString()->c_str());
+  d = s.getRulesets().front()->getDeclarations().front();
+  EXPECT_STREQ("key", d->getProperty().c_str());
+  EXPECT_STREQ("10", d->getValue().toString().c_str());
 }
 
 
 TEST(LessParserTest, DeepVariable) {
   istringstream in("@x: 10; @y: 'x'; selector {key: @@y}");
 
-  ValueProcessor vp;
-  ParameterRulesetLibrary pr(&vp);
-
-  LessTokenizer t(&in);
-  LessParser p(&t, &pr, &vp);
+  SourceList sources;
+  LessTokenizer t(in, "test");
+  LessParser p(t, sources);
+  LessStylesheet less;
+  ProcessingContext context;
   Stylesheet s;
   Declaration* d;
   
-  p.parseStylesheet(&s);
+  sources.addSource("test");
+  p.parseStylesheet(less);
+  less.process(s, context);
 
-  ASSERT_EQ((uint)1, s.getRulesets()->size());
-  ASSERT_EQ((uint)1, s.getRulesets()->at(0)->getDeclarations()->size());
+  ASSERT_EQ(1U, s.getRulesets().size());
+  ASSERT_EQ(1U, s.getRulesets().front()->getDeclarations().size());
 
-  d = s.getRulesets()->at(0)->getDeclarations()->at(0);
-  EXPECT_STREQ("key", d->getProperty()->c_str());
-  EXPECT_STREQ("10", d->getValue()->toString()->c_str());
+  d = s.getRulesets().front()->getDeclarations().front();
+  EXPECT_STREQ("key", d->getProperty().c_str());
+  EXPECT_STREQ("10", d->getValue().toString().c_str());
 }
 
 // mixin
 TEST(LessParserTest, Mixin) {
   istringstream in("mixin {key: 10} selector {mixin}");
 
-  ValueProcessor vp;
-  ParameterRulesetLibrary pr(&vp);
-
-  LessTokenizer t(&in);
-  LessParser p(&t, &pr, &vp);
+  SourceList sources;
+  LessTokenizer t(in, "test");
+  LessParser p(t, sources);
+  LessStylesheet less;
+  ProcessingContext context;
   Stylesheet s;
 
   Ruleset* set;
   Declaration* d;
+  TokenList value;
   
-  p.parseStylesheet(&s);
+  sources.addSource("test");
+  p.parseStylesheet(less);
+  less.process(s, context);
 
-  ASSERT_EQ((uint)2, s.getRulesets()->size());
-  set = s.getRulesets()->at(1);
-  ASSERT_STREQ("selector", set->getSelector()->toString()->c_str());
+  ASSERT_EQ(2U, s.getRulesets().size());
+  set = s.getRulesets().back();
+  ASSERT_STREQ("selector", set->getSelector().toString().c_str());
   
-  ASSERT_EQ((uint)1, set->getDeclarations()->size());
-  d = set->getDeclarations()->at(0);
+  ASSERT_EQ(1U, set->getDeclarations().size());
+  d = set->getDeclarations().front();
 
-  EXPECT_STREQ("key", d->getProperty()->c_str());
-  EXPECT_STREQ("10", d->getValue()->toString()->c_str());
+  EXPECT_STREQ("key", d->getProperty().c_str());
+
+  // whitespace around the value is kept until it is written
+  value = d->getValue();
+  value.trim();
+  EXPECT_STREQ("10", value.toString().c_str());
 }
 
 // nested rule
 TEST(LessParserTest, NestedRule) {
   istringstream in("selector { nested {key: value} }");
 
-  ValueProcessor vp;
-  ParameterRulesetLibrary pr(&vp);
-
-  LessTokenizer t(&in);
-  LessParser p(&t, &pr, &vp);
+  SourceList sources;
+  LessTokenizer t(in, "test");
+  LessParser p(t, sources);
+  LessStylesheet less;
+  ProcessingContext context;
   Stylesheet s;
 
   Ruleset* set;
   Declaration* d;
+  TokenList value;
   
-  p.parseStylesheet(&s);
+  sources.addSource("test");
+  p.parseStylesheet(less);
+  less.process(s, context);
 
-  ASSERT_EQ((uint)2, s.getRulesets()->size());
+  ASSERT_EQ(2U, s.getRulesets().size());
 
   // Check for 'selector {}'
-  set = s.getRulesets()->at(0);
-  ASSERT_STREQ("selector", set->getSelector()->toString()->c_str());
-  ASSERT_EQ((uint)0, set->getDeclarations()->size());
+  set = s.getRulesets().front();
+  ASSERT_STREQ("selector", set->getSelector().toString().c_str());
+  ASSERT_EQ(0U, set->getDeclarations().size());
 
   // Check for 'selector nested {key: value}'
-  set = s.getRulesets()->at(1);
-  ASSERT_STREQ("selector nested", set->getSelector()->toString()->c_str());
+  set = s.getRulesets().back();
+  ASSERT_STREQ("selector nested", set->getSelector().toString().c_str());
 
-  ASSERT_EQ((uint)1, set->getDeclarations()->size());
-  d = set->getDeclarations()->at(0);
+  ASSERT_EQ(1U, set->getDeclarations().size());
+  d = set->getDeclarations().front();
 
-  EXPECT_STREQ("key", d->getProperty()->c_str());
-  EXPECT_STREQ("value", d->getValue()->toString()->c_str());
+  EXPECT_STREQ("key", d->getProperty().c_str());
+
+  // whitespace around the value is kept until it is written
+  value = d->getValue();
+  value.trim();
+  EXPECT_STREQ("value", value.toString().c_str());
 }
 
 // parameter mixin
 TEST(LessParserTest, ParameterMixin) {
   istringstream in(".mixin(@x) {key: @x} selector {.mixin(10);}");
 
-  ValueProcessor vp;
-  ParameterRulesetLibrary pr(&vp);
-
-  LessTokenizer t(&in);
-  LessParser p(&t, &pr, &vp);
+  SourceList sources;
+  LessTokenizer t(in, "test");
+  LessParser p(t, sources);
+  LessStylesheet less;
+  ProcessingContext context;
   Stylesheet s;
 
   Ruleset* set;
   Declaration* d;
   
-  p.parseStylesheet(&s);
+  sources.addSource("test");
+  p.parseStylesheet(less);
+  less.process(s, context);
 
-  ASSERT_EQ((uint)1, s.getRulesets()->size());
-  set = s.getRulesets()->at(0);
-  ASSERT_STREQ("selector", set->getSelector()->toString()->c_str());
+  ASSERT_EQ(1U, s.getRulesets().size());
+  set = s.getRulesets().front();
+  ASSERT_STREQ("selector", set->getSelector().toString().c_str());
   
-  ASSERT_EQ((uint)1, set->getDeclarations()->size());
-  d = set->getDeclarations()->at(0);
+  ASSERT_EQ(1U, set->getDeclarations().size());
+  d = set->getDeclarations().front();
 
-  EXPECT_STREQ("key", d->getProperty()->c_str());
-  EXPECT_STREQ("10", d->getValue()->toString()->c_str());
+  EXPECT_STREQ("key", d->getProperty().c_str());
+  EXPECT_STREQ("10", d->getValue().toString().c_str());
 }
@@ -0,0 +1,389 @@
+/*
+ * Copyright 2012 Bram van der Kroef
+ *
+ * This file is part of LESS CSS Compiler.
+ *
+ * LESS CSS Compiler is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LESS CSS Compiler is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LESS CSS Compiler.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Bram van der Kroef <bram@vanderkroef.net>
+ */
+
+#include "gtest/gtest.h"
+
+#include <config.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+/**
+ * Runs the lessc program on files in a temporary directory, for the
+ * options that are handled outside of the library.
+ */
+class LesscTest: public ::testing::Test {
+protected:
+  std::string dir;
+
+  virtual void SetUp() {
+    char path[] = "/tmp/lessc_test.XXXXXX";
+
+    ASSERT_TRUE(mkdtemp(path) != NULL);
+    dir = path;
+  }
+
+  virtual void TearDown() {
+    EXPECT_EQ(0, std::system(("rm -rf '" + dir + "'").c_str()));
+  }
+
+  void writeFile(const std::string &name, const std::string &content) {
+    std::ofstream out((dir + "/" + name).c_str(), std::ios::binary);
+    out << content;
+  }
+
+  std::string readFile(const std::string &name) {
+    std::ifstream in((dir + "/" + name).c_str(), std::ios::binary);
+    std::ostringstream content;
+
+    content << in.rdbuf();
+    return content.str();
+  }
+
+  /**
+   * Run a shell command in the temporary directory and return what it
+   * writes to stdout, without the trailing newline.
+   */
+  std::string run(const std::string &command) {
+    std::string output;
+    char buffer[1024];
+    size_t length;
+    FILE* p = popen(("cd '" + dir + "' && " + command).c_str(), "r");
+
+    if (p == NULL)
+      return output;
+    while ((length = fread(buffer, 1, sizeof(buffer), p)) > 0)
+      output.append(buffer, length);
+    pclose(p);
+
+    if (!output.empty() && output[output.size() - 1] == '\n')
+      output.erase(output.size() - 1);
+    return output;
+  }
+
+  /**
+   * Run lessc with the arguments and return the css it writes.
+   */
+  std::string lessc(const std::string &arguments) {
+    return run(LESSC " " + arguments + " 2>/dev/null");
+  }
+
+  /**
+   * Run lessc with the arguments and return its warnings and errors.
+   */
+  std::string lesscErrors(const std::string &arguments) {
+    return run(LESSC " " + arguments + " 2>&1 >/dev/null");
+  }
+};
+
+// a mixin called twice adds the same declarations twice
+TEST_F(LesscTest, OptimizeDuplicateMixinCall) {
+  writeFile("in.less", ".mix() {color: red}\n"
+            ".a {.mix(); .mix();}\n"
+            ".b {color: red}\n");
+  EXPECT_EQ(".a,.b{color:red}", lessc("--optimize in.less"));
+}
+
+// font sets line-height, so neither can be dropped or moved
+TEST_F(LesscTest, OptimizeShorthandCascade) {
+  writeFile("in.less", ".a {font: 12px serif; line-height: 2}\n"
+            "a {line-height: 2}\n"
+            "b {font: 12px serif}\n"
+            "c {line-height: 2}\n");
+  EXPECT_EQ(".a{font:12px serif;line-height:2}"
+            "a{line-height:2}b{font:12px serif}c{line-height:2}",
+            lessc("--optimize in.less"));
+
+  writeFile("in.less", "a {line-height: 2}\n"
+            "c {line-height: 2}\n");
+  EXPECT_EQ("a,c{line-height:2}", lessc("--optimize in.less"));
+}
+
+// --optimize writes values in their shortest form
+TEST_F(LesscTest, OptimizeValues) {
+  writeFile("in.less", ".a {\n"
+            "  margin: 0px 0.50em 10.0px -0.5px;\n"
+            "  color: #FFFFFF;\n"
+            "  background: #ff0000 url(\"img/a.png\");\n"
+            "  border-color: black;\n"
+            "  font-weight: bold;\n"
+            "  padding: 0 !important;\n"
+            "  transform: translate( 1px , 2px );\n"
+            "}\n");
+  EXPECT_EQ(".a{margin:0 .5em 10px -.5px;color:#fff;"
+            "background:red url(img/a.png);border-color:#000;"
+            "font-weight:700;padding:0!important;"
+            "transform:translate(1px,2px)}",
+            lessc("--optimize in.less"));
+}
+
+// zero lengths keep their unit where it matters
+TEST_F(LesscTest, OptimizeZeroUnits) {
+  writeFile("in.less", ".a {\n"
+            "  width: min(0px, 1em);\n"
+            "  left: var(--x, 0px);\n"
+            "  flex: 1 1 0px;\n"
+            "  flex-basis: 0%;\n"
+            "  top: 0px;\n"
+            "}\n");
+  EXPECT_EQ(".a{width:min(0px,1em);left:var(--x,0px);flex:1 1 0px;"
+            "flex-basis:0%;top:0}",
+            lessc("--optimize in.less"));
+}
+
+// an IE filter reads the hash after '=' as #aarrggbb
+TEST_F(LesscTest, OptimizeFilterHash) {
+  writeFile("in.less", ".a {filter: progid:DXImageTransform.Microsoft."
+            "gradient(startColorstr=#FFFFFFFF, endColorstr=#80000000)}\n");
+  EXPECT_EQ(".a{filter:progid:DXImageTransform.Microsoft.gradient("
+            "startColorstr=#FFFFFFFF,endColorstr=#80000000)}",
+            lessc("--optimize in.less"));
+}
+
+// generic family names and names that aren't identifiers stay quoted
+TEST_F(LesscTest, OptimizeFontNames) {
+  writeFile("in.less", ".a {font-family: \"Helvetica Neue\", \"Arial\", "
+            "\"serif\", \"Font 1\"}\n");
+  EXPECT_EQ(".a{font-family:Helvetica Neue,Arial,\"serif\",\"Font 1\"}",
+            lessc("--optimize in.less"));
+}
+
+// imported css keeps its media list, also when nested
+TEST_F(LesscTest, BundleCssMediaList) {
+  EXPECT_EQ(0, std::system(("mkdir '" + dir + "/sub'").c_str()));
+  writeFile("sub/print.css", "@import \"inner.css\" screen;\n"
+            ".p {color: blue}\n");
+  writeFile("sub/inner.css", ".i {background: url(i.png)}\n");
+  writeFile("in.less", "@import \"sub/print.css\" print;\n"
+            ".m {color: green}\n");
+  EXPECT_EQ("@media print and screen{.i{background:url(\"sub/i.png\")}}"
+            "@media print{.p{color:blue}}.m{color:green}",
+            lessc("--bundle-css in.less"));
+  EXPECT_EQ("@import \"sub/print.css\" print;.m{color:green}",
+            lessc("in.less"));
+}
+
+// css that imports a remote file is left to the browser
+TEST_F(LesscTest, BundleCssRemoteImport) {
+  writeFile("remote.css", "@import \"http://example.com/a.css\";\n"
+            ".r {color: red}\n");
+  writeFile("in.less", "@import \"remote.css\";\n"
+            ".m {color: green}\n");
+  EXPECT_EQ("@import \"remote.css\";.m{color:green}",
+            lessc("--bundle-css in.less"));
+}
+
+// the rules of a.css can't be split around an @import that is kept
+TEST_F(LesscTest, BundleCssNestedRemoteImport) {
+  EXPECT_EQ(0, std::system(("mkdir '" + dir + "/sub'").c_str()));
+  writeFile("sub/a.css", "@import \"c.css\";\n"
+            "@import \"b.css\";\n"
+            ".a {x: y}\n");
+  writeFile("sub/c.css", ".c {d: e}\n");
+  writeFile("sub/b.css", "@import \"http://example.com/y.css\";\n"
+            ".b {f: g}\n");
+  writeFile("in.less", "@import \"sub/a.css\";\n"
+            ".m {n: o}\n");
+  EXPECT_EQ("@import \"sub/a.css\";.m{n:o}",
+            lessc("--bundle-css in.less"));
+
+  writeFile("sub/b.css", "@import \"missing.css\";\n"
+            ".b {f: g}\n");
+  EXPECT_EQ("@import \"sub/a.css\";.m{n:o}",
+            lessc("--bundle-css in.less"));
+  EXPECT_EQ("", lesscErrors("--bundle-css in.less"));
+
+  writeFile("sub/b.css", "@import \"a.css\";\n"
+            ".b {f: g}\n");
+  EXPECT_EQ(".c{d:e}.b{f:g}.a{x:y}.m{n:o}",
+            lessc("--bundle-css in.less"));
+}
+
+// files over the data-uri() limit are linked instead of inlined
+TEST_F(LesscTest, DataUriMaxSize) {
+  writeFile("big.txt", std::string(2000, 'a'));
+  writeFile("small.txt", "ab");
+  writeFile("in.less", ".a {background: data-uri(\"big.txt\")}\n"
+            ".b {background: data-uri(\"small.txt\")}\n");
+  EXPECT_EQ(".a{background:url(\"big.txt\")}"
+            ".b{background:url(\"data:text/plain;charset=UTF-8,ab\")}",
+            lessc("--data-uri-max-size=1 in.less"));
+  EXPECT_EQ(".a{background:url(\"data:text/plain;charset=UTF-8," +
+            std::string(2000, 'a') + "\")}"
+            ".b{background:url(\"data:text/plain;charset=UTF-8,ab\")}",
+            lessc("--data-uri-max-size=0 in.less"));
+}
+
+#ifdef WITH_LIBPNG
+// a red 4x3 and a blue 2x5 png image
+static const char HOME_PNG[] =
+  "\x89\x50\x4e\x47\x0d\x0a\x1a\x0a\x00\x00\x00\x0d\x49\x48\x44\x52"
+  "\x00\x00\x00\x04\x00\x00\x00\x03\x08\x02\x00\x00\x00\x3b\x96\x39"
+  "\x91\x00\x00\x00\x10\x49\x44\x41\x54\x78\x9c\x63\xf8\xcf\xc0\x00"
+  "\x47\x0c\x38\x39\x00\xf5\x31\x0b\xf5\x35\x7b\xfb\x82\x00\x00\x00"
+  "\x00\x49\x45\x4e\x44\xae\x42\x60\x82";
+static const char USER_PNG[] =
+  "\x89\x50\x4e\x47\x0d\x0a\x1a\x0a\x00\x00\x00\x0d\x49\x48\x44\x52"
+  "\x00\x00\x00\x02\x00\x00\x00\x05\x08\x02\x00\x00\x00\xe0\xd1\xaa"
+  "\xcb\x00\x00\x00\x0f\x49\x44\x41\x54\x78\x9c\x63\x60\x60\xf8\x0f"
+  "\x46\xb8\x29\x00\xa4\x7e\x09\xf7\x9d\x24\xa7\x91\x00\x00\x00\x00"
+  "\x49\x45\x4e\x44\xae\x42\x60\x82";
+
+// the second image does not fit on the first shelf
+TEST_F(LesscTest, SpriteAtlas) {
+  std::string atlas;
+
+  EXPECT_EQ(0, std::system(("mkdir '" + dir + "/img'").c_str()));
+  writeFile("img/home.png", std::string(HOME_PNG, sizeof(HOME_PNG) - 1));
+  writeFile("img/user.png", std::string(USER_PNG, sizeof(USER_PNG) - 1));
+  writeFile("in.less",
+            "@atlas: \"img/icons.png\";\n"
+            ".h {background: sprite(@atlas, url(\"img/home.png\"))}\n"
+            ".u {\n"
+            "  background-position: sprite-position(@atlas, url(\"img/user.png\"));\n"
+            "  width: sprite-width(@atlas, url(\"img/user.png\"));\n"
+            "  height: sprite-height(@atlas, url(\"img/user.png\"));\n"
+            "  background-image: sprite-url(@atlas);\n"
+            "}\n");
+  EXPECT_EQ(".h{background:url(\"img/icons.png\") 0 0}"
+            ".u{background-position:0 -3px;width:2px;height:5px;"
+            "background-image:url(\"img/icons.png\")}",
+            lessc("in.less"));
+
+  // the IHDR chunk holds the size of the atlas: 4x8
+  atlas = readFile("img/icons.png");
+  ASSERT_GE(atlas.size(), 24u);
+  EXPECT_EQ(0, atlas.compare(1, 3, "PNG"));
+  EXPECT_EQ(std::string("\x00\x00\x00\x04\x00\x00\x00\x08", 8),
+            atlas.substr(16, 8));
+}
+#endif
+
+// imports that are cached between stylesheets compile as they do alone
+TEST_F(LesscTest, BatchMatchesSingleFile) {
+  std::string p, q;
+
+  writeFile("lib.less", "@c: red;\n"
+            ".m(@w: 1px) {border: @w solid @c}\n");
+  writeFile("p.less", "@import \"lib.less\";\n"
+            ".p {.m(2px); color: @c}\n");
+  writeFile("q.less", "@import (reference) \"lib.less\";\n"
+            "@c: blue;\n"
+            ".q {.m}\n");
+  p = lessc("p.less") + "\n";
+  q = lessc("q.less") + "\n";
+  EXPECT_EQ(".p{border:2px solid red;color:red}\n", p);
+  EXPECT_EQ(".q{border:1px solid blue}\n", q);
+
+  EXPECT_EQ("", lessc("--batch p.less:p.css q.less:q.css"));
+  EXPECT_EQ(p, readFile("p.css"));
+  EXPECT_EQ(q, readFile("q.css"));
+
+  writeFile("manifest", "# both in one file\n"
+            "p.less:all.css\n"
+            "\n"
+            "q.less:all.css\n");
+  EXPECT_EQ("", lessc("--batch=manifest"));
+  EXPECT_EQ(p + q, readFile("all.css"));
+}
+
+// the first query only holds an at-rule, which can't be moved
+TEST_F(LesscTest, MergeMediaAtRule) {
+  writeFile("in.less", "@media print {\n"
+            "  @supports (display: grid) {.a {b: c}}\n"
+            "}\n"
+            ".x {b: d}\n"
+            "@media print {.y {z: 1}}\n");
+  EXPECT_EQ("@media print{@supports (display: grid) {.a {b: c}}}"
+            ".x{b:d}@media print{.y{z:1}}",
+            lessc("--merge-media in.less"));
+  EXPECT_NE(std::string::npos,
+            lesscErrors("--merge-media in.less").find("Not merging"));
+}
+
+TEST_F(LesscTest, MergeMedia) {
+  writeFile("in.less", "@media print {.a {b: c}}\n"
+            ".x {e: d}\n"
+            "@media print {.y {b: 1}}\n");
+  EXPECT_EQ(".x{e:d}@media print{.a{b:c}.y{b:1}}",
+            lessc("--merge-media in.less"));
+  EXPECT_EQ("", lesscErrors("--merge-media in.less"));
+
+  // .x sets b as well, so .a can't move past it
+  writeFile("in.less", "@media print {.a {b: c}}\n"
+            ".x {b: d}\n"
+            "@media print {.y {b: 1}}\n");
+  EXPECT_EQ("@media print{.a{b:c}}.x{b:d}@media print{.y{b:1}}",
+            lessc("--merge-media in.less"));
+  EXPECT_EQ("in.less: Line 0, Column 18 Warning: Not merging @media print "
+            "with the one after it; a rule in between sets the same "
+            "properties.",
+            lesscErrors("--merge-media in.less"));
+}
+
+// write errors are reported, also when the last buffer is flushed
+TEST_F(LesscTest, OutputWriteError) {
+  writeFile("in.less", ".a {b: c}\n");
+  EXPECT_EQ(" Error: Error writing output",
+            lesscErrors("-o /dev/full in.less"));
+  EXPECT_EQ(" Error: Error writing output",
+            lesscErrors("--stream -o /dev/full in.less"));
+}
+
+// the sizes are read from the headers, without decoding the images
+TEST_F(LesscTest, ImageHeaders) {
+  // 16x8 with a red background in the global color table
+  writeFile("a.gif", std::string("GIF89a\x10\x00\x08\x00\x80\x01\x00"
+                                 "\x00\x00\x00\xff\x00\x00", 19));
+  // lossy 100x50 and extended 300x150
+  writeFile("a.webp", std::string("RIFF\x16\x00\x00\x00WEBPVP8 "
+                                  "\x0a\x00\x00\x00\x00\x00\x00"
+                                  "\x9d\x01\x2a\x64\x00\x32\x00", 30));
+  writeFile("b.webp", std::string("RIFF\x16\x00\x00\x00WEBPVP8X"
+                                  "\x0a\x00\x00\x00\x00\x00\x00\x00"
+                                  "\x2b\x01\x00\x95\x00\x00", 30));
+  // the height follows from the width and the viewBox
+  writeFile("a.svg", "<?xml version=\"1.0\"?>\n"
+            "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"20px\" "
+            "viewBox=\"0 0 40 20\"></svg>\n");
+  // a 64x32 grayscale SOF2 frame after an APP0 and a DHT segment
+  writeFile("a.jpg", std::string("\xff\xd8\xff\xe0\x00\x04\x00\x00"
+                                 "\xff\xc4\x00\x04\x00\x00"
+                                 "\xff\xc2\x00\x0b\x08\x00\x20\x00\x40"
+                                 "\x01\x01\x11\x00\xff\xd9", 29));
+  writeFile("in.less",
+            ".gif {w: imgwidth(url(\"a.gif\")); h: imgheight(url(\"a.gif\"));"
+            " b: imgbackground(url(\"a.gif\"))}\n"
+            ".webp {w: imgwidth(url(\"a.webp\")); h: imgheight(url(\"a.webp\"))}\n"
+            ".webpx {w: imgwidth(url(\"b.webp\")); h: imgheight(url(\"b.webp\"))}\n"
+            ".svg {w: imgwidth(url(\"a.svg\")); h: imgheight(url(\"a.svg\"))}\n"
+            ".jpg {w: imgwidth(url(\"a.jpg\")); h: imgheight(url(\"a.jpg\"));"
+            " b: imgbackground(url(\"a.jpg\"))}\n");
+  EXPECT_EQ(".gif{w:16px;h:8px;b:red}"
+            ".webp{w:100px;h:50px}"
+            ".webpx{w:300px;h:150px}"
+            ".svg{w:20px;h:10px}"
+            ".jpg{w:64px;h:32px;b:#000}",
+            lessc("in.less"));
+}
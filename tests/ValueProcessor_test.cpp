@@ -20,266 +20,378 @@
  */
 
 #include "value/ValueProcessor.h"
+#include "value/ValueScope.h"
 #include "gtest/gtest.h"
 
+#include <map>
+#include <string>
+
 TEST(ValueProcessorTest, Operators) {
   TokenList l;
   ValueProcessor vp;
+  std::map<std::string, SharedTokenList> variables;
+  ValueScope scope(variables);
 
   // add
-  l.push(new Token("1", Token::NUMBER));
-  l.push(new Token("+", Token::DELIMITER));
-  l.push(new Token("1", Token::NUMBER));
+  l.push_back(Token("1", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token("+", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("1", Token::NUMBER, 0, 0, "test"));
 
-  vp.processValue(&l);
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)1, l.size());
-  ASSERT_EQ(Token::NUMBER, l.front()->type);
-  EXPECT_STREQ("2", l.front()->str.c_str());
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::NUMBER, l.front().type);
+  EXPECT_STREQ("2", l.front().c_str());
 
-  // substract
-  l.push(new Token("-", Token::DELIMITER));
-  l.push(new Token("1", Token::NUMBER));
+  // substract. '2 -1' would be a list with a negative number.
+  l.push_back(Token(" ", Token::WHITESPACE, 0, 0, "test"));
+  l.push_back(Token("-", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token(" ", Token::WHITESPACE, 0, 0, "test"));
+  l.push_back(Token("1", Token::NUMBER, 0, 0, "test"));
 
-  vp.processValue(&l);
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)1, l.size());
-  ASSERT_EQ(Token::NUMBER, l.front()->type);
-  EXPECT_STREQ("1", l.front()->str.c_str());
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::NUMBER, l.front().type);
+  EXPECT_STREQ("1", l.front().c_str());
 
   // multiply
-  l.push(new Token("*", Token::DELIMITER));
-  l.push(new Token("5", Token::NUMBER));
+  l.push_back(Token("*", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("5", Token::NUMBER, 0, 0, "test"));
 
-  vp.processValue(&l);
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)1, l.size());
-  ASSERT_EQ(Token::NUMBER, l.front()->type);
-  EXPECT_STREQ("5", l.front()->str.c_str());
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::NUMBER, l.front().type);
+  EXPECT_STREQ("5", l.front().c_str());
 
   // divide
-  l.push(new Token("/", Token::DELIMITER));
-  l.push(new Token("2", Token::NUMBER));
+  l.push_back(Token("/", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("2", Token::NUMBER, 0, 0, "test"));
 
-  vp.processValue(&l);
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)1, l.size());
-  ASSERT_EQ(Token::NUMBER, l.front()->type);
-  EXPECT_STREQ("2.5", l.front()->str.c_str());
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::NUMBER, l.front().type);
+  EXPECT_STREQ("2.5", l.front().c_str());
 
-  // compare
-  l.push(new Token("<", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
+  // compare, which is done in guard conditions
+  l.push_back(Token("<", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
 
-  vp.processValue(&l);
-  
-  ASSERT_EQ((uint)1, l.size());
-  ASSERT_EQ(Token::IDENTIFIER, l.front()->type);
-  EXPECT_STREQ("true", l.front()->str.c_str());
+  EXPECT_TRUE(vp.validateCondition(l, scope));
 }
 
 TEST(ValueProcessorTest, OperandMismatch) {
   TokenList l;
   ValueProcessor vp;
+  std::map<std::string, SharedTokenList> variables;
+  ValueScope scope(variables);
   
-  l.push(new Token("true", Token::IDENTIFIER));
-  l.push(new Token("+", Token::DELIMITER));
-  l.push(new Token("#FFF", Token::HASH));
-
-  EXPECT_THROW(vp.processValue(&l), ValueException*);
+  l.push_back(Token("true", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("+", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("#FFF", Token::HASH, 0, 0, "test"));
+
+  // operations that are not defined for the operands are written as
+  // they are
+  EXPECT_NO_THROW(vp.processValue(l, scope));
+  EXPECT_STREQ("true + #FFF", l.toString().c_str());
 }
 
 TEST(ValueProcessorTest, OperatorsInParens) {
   TokenList l;
   ValueProcessor vp;
-
-  l.push(new Token("25", Token::NUMBER));
-  l.push(new Token("/", Token::DELIMITER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("2", Token::NUMBER));
-  l.push(new Token("+", Token::DELIMITER));
-  l.push(new Token("3", Token::NUMBER));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-
-  vp.processValue(&l);
+  std::map<std::string, SharedTokenList> variables;
+  ValueScope scope(variables);
+
+  l.push_back(Token("25", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token("/", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("2", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token("+", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("3", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)1, l.size());
-  EXPECT_STREQ("5", l.front()->str.c_str());
-  ASSERT_EQ(Token::NUMBER, l.front()->type);
+  ASSERT_EQ(1U, l.size());
+  EXPECT_STREQ("5", l.front().c_str());
+  ASSERT_EQ(Token::NUMBER, l.front().type);
 }
 
 
 TEST(ValueProcessorTest, StringOperations) {
   TokenList l;
   ValueProcessor vp;
+  std::map<std::string, SharedTokenList> variables;
+  ValueScope scope(variables);
 }
 TEST(ValueProcessorTest, ColorOperations) {
   TokenList l;
   ValueProcessor vp;
-
-  l.push(new Token("rgb", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-
-  vp.processValue(&l);
+  std::map<std::string, SharedTokenList> variables;
+  ValueScope scope(variables);
+
+  l.push_back(Token("rgb", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)1, l.size());
-  EXPECT_STREQ("#0a0a0a", l.front()->str.c_str());
-  ASSERT_EQ(Token::HASH, l.front()->type);
+  ASSERT_EQ(1U, l.size());
+  EXPECT_STREQ("#0a0a0a", l.front().c_str());
+  ASSERT_EQ(Token::HASH, l.front().type);
 
   l.clear();
-  l.push(new Token("rgba", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10%", Token::PERCENTAGE));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-
-  vp.processValue(&l);
+  l.push_back(Token("rgba", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10%", Token::PERCENTAGE, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)10, l.size());
-  EXPECT_STREQ("rgba(10,10,10,0.1)", l.toString()->c_str());
+  ASSERT_EQ(10U, l.size());
+  EXPECT_STREQ("rgba(10,10,10,0.1)", l.toString().c_str());
 
   l.clear();
-  l.push(new Token("lighten", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("#AAA", Token::HASH));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10%", Token::PERCENTAGE));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-
-  vp.processValue(&l);
+  l.push_back(Token("lighten", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("#AAA", Token::HASH, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10%", Token::PERCENTAGE, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)1, l.size());
-  ASSERT_EQ(Token::HASH, l.front()->type);
-  EXPECT_STREQ("#c3c3c3", l.front()->str.c_str());
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::HASH, l.front().type);
+  EXPECT_STREQ("#c3c3c3", l.front().c_str());
 
   l.clear();
-  l.push(new Token("darken", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("#AAA", Token::HASH));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10%", Token::PERCENTAGE));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-
-  vp.processValue(&l);
+  l.push_back(Token("darken", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("#AAA", Token::HASH, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10%", Token::PERCENTAGE, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)1, l.size());
-  ASSERT_EQ(Token::HASH, l.front()->type);
-  EXPECT_STREQ("#909090", l.front()->str.c_str());
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::HASH, l.front().type);
+  EXPECT_STREQ("#909090", l.front().c_str());
 
   l.clear();
-  l.push(new Token("saturate", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("#AAA", Token::HASH));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10%", Token::PERCENTAGE));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-
-  vp.processValue(&l);
+  l.push_back(Token("saturate", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("#AAA", Token::HASH, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10%", Token::PERCENTAGE, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)1, l.size());
-  ASSERT_EQ(Token::HASH, l.front()->type);
-  EXPECT_STREQ("#b2a1a1", l.front()->str.c_str());
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::HASH, l.front().type);
+  EXPECT_STREQ("#b3a2a2", l.front().c_str());
 
   l.clear();
-  l.push(new Token("desaturate", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("#123456", Token::HASH));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10%", Token::PERCENTAGE));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-
-  vp.processValue(&l);
+  l.push_back(Token("desaturate", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("#123456", Token::HASH, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10%", Token::PERCENTAGE, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)1, l.size());
-  ASSERT_EQ(Token::HASH, l.front()->type);
-  EXPECT_STREQ("#173451", l.front()->str.c_str());
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::HASH, l.front().type);
+  EXPECT_STREQ("#173451", l.front().c_str());
 
   l.clear();
-  l.push(new Token("fadein", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("rgba", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10%", Token::PERCENTAGE));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10%", Token::PERCENTAGE));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-
-  vp.processValue(&l);
+  l.push_back(Token("fadein", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("rgba", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10%", Token::PERCENTAGE, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10%", Token::PERCENTAGE, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)10, l.size());
-  EXPECT_STREQ("rgba(10,10,10,0.11)", l.toString()->c_str());
+  ASSERT_EQ(10U, l.size());
+  EXPECT_STREQ("rgba(10,10,10,0.2)", l.toString().c_str());
 
   l.clear();
-  l.push(new Token("fadeout", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("#0A0A0A", Token::HASH));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10%", Token::PERCENTAGE));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-
-  vp.processValue(&l);
+  l.push_back(Token("fadeout", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("#0A0A0A", Token::HASH, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10%", Token::PERCENTAGE, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  vp.processValue(l, scope);
   
-  ASSERT_EQ((uint)10, l.size());
-  EXPECT_STREQ("rgba(10,10,10,0.9)", l.toString()->c_str());
+  ASSERT_EQ(10U, l.size());
+  EXPECT_STREQ("rgba(10,10,10,0.9)", l.toString().c_str());
+}
+
+TEST(ValueProcessorTest, UnitConversion) {
+  TokenList l;
+  ValueProcessor vp;
+  std::map<std::string, SharedTokenList> variables;
+  ValueScope scope(variables);
+
+  // 1in is 72pt
+  l.push_back(Token("1in", Token::DIMENSION, 0, 0, "test"));
+  l.push_back(Token("+", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("72pt", Token::DIMENSION, 0, 0, "test"));
+
+  vp.processValue(l, scope);
+
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::DIMENSION, l.front().type);
+  EXPECT_STREQ("144pt", l.front().c_str());
+
+  l.clear();
+  l.push_back(Token("1s", Token::DIMENSION, 0, 0, "test"));
+  l.push_back(Token("+", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("500ms", Token::DIMENSION, 0, 0, "test"));
+
+  vp.processValue(l, scope);
+
+  ASSERT_EQ(1U, l.size());
+  EXPECT_STREQ("1500ms", l.front().c_str());
+
+  // relative lengths depend on the font, so they can't be converted
+  l.clear();
+  l.push_back(Token("1em", Token::DIMENSION, 0, 0, "test"));
+  l.push_back(Token("+", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("1ex", Token::DIMENSION, 0, 0, "test"));
+
+  EXPECT_NO_THROW(vp.processValue(l, scope));
+  EXPECT_STREQ("1em + 1ex", l.toString().c_str());
+}
+
+TEST(ValueProcessorTest, ColorNames) {
+  TokenList l;
+  ValueProcessor vp;
+  std::map<std::string, SharedTokenList> variables;
+  ValueScope scope(variables);
+
+  // names are colors in operations and functions
+  l.push_back(Token("darken", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("white", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10%", Token::PERCENTAGE, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  vp.processValue(l, scope);
+
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::HASH, l.front().type);
+  EXPECT_STREQ("#e6e6e6", l.front().c_str());
+
+  // computed colors are written as the shortest of the name and hex
+  l.clear();
+  l.push_back(Token("#800000", Token::HASH, 0, 0, "test"));
+  l.push_back(Token("+", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("#000", Token::HASH, 0, 0, "test"));
+
+  vp.processValue(l, scope);
+
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::IDENTIFIER, l.front().type);
+  EXPECT_STREQ("maroon", l.front().c_str());
+
+  l.clear();
+  l.push_back(Token("blue", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("*", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("1", Token::NUMBER, 0, 0, "test"));
+
+  vp.processValue(l, scope);
+
+  ASSERT_EQ(1U, l.size());
+  ASSERT_EQ(Token::HASH, l.front().type);
+  EXPECT_STREQ("#00f", l.front().c_str());
+
+  // a name that is not computed is left as it is
+  l.clear();
+  l.push_back(Token("blue", Token::IDENTIFIER, 0, 0, "test"));
+
+  vp.processValue(l, scope);
+
+  EXPECT_STREQ("blue", l.toString().c_str());
 }
 
 TEST(ValueProcessorTest, FunctionErrors) {
   TokenList l;
   ValueProcessor vp;
+  std::map<std::string, SharedTokenList> variables;
+  ValueScope scope(variables);
 
-  // function with wrong arguments.
-  l.push(new Token("rgb", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("true", Token::IDENTIFIER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("\"abc\"", Token::STRING));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10px", Token::DIMENSION));
-  l.push(new Token(")", Token::PAREN_CLOSED));
+  // Function calls that don't match the parameters of the function
+  // are written as they are, like calls of unknown functions.
 
-  EXPECT_THROW(vp.processValue(&l), ParseException*);
+  // function with wrong arguments.
+  l.push_back(Token("rgb", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("true", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("\"abc\"", Token::STRING, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10px", Token::DIMENSION, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  EXPECT_NO_THROW(vp.processValue(l, scope));
+  EXPECT_STREQ("rgb(true, \"abc\", 10px)", l.toString().c_str());
 
   // too many arguments.
   l.clear();
-  l.push(new Token("rgb", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(")", Token::PAREN_CLOSED));
+  l.push_back(Token("rgb", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
   
-  EXPECT_THROW(vp.processValue(&l), ParseException*);
+  EXPECT_NO_THROW(vp.processValue(l, scope));
+  EXPECT_STREQ("rgb(10, 10, 10, 10)", l.toString().c_str());
 
   // not enough arguments.
   l.clear();
-  l.push(new Token("rgb", Token::IDENTIFIER));
-  l.push(new Token("(", Token::PAREN_OPEN));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(",", Token::DELIMITER));
-  l.push(new Token("10", Token::NUMBER));
-  l.push(new Token(")", Token::PAREN_CLOSED));
-
-  EXPECT_THROW(vp.processValue(&l), ParseException*);
+  l.push_back(Token("rgb", Token::IDENTIFIER, 0, 0, "test"));
+  l.push_back(Token("(", Token::PAREN_OPEN, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(",", Token::DELIMITER, 0, 0, "test"));
+  l.push_back(Token("10", Token::NUMBER, 0, 0, "test"));
+  l.push_back(Token(")", Token::PAREN_CLOSED, 0, 0, "test"));
+
+  EXPECT_NO_THROW(vp.processValue(l, scope));
+  EXPECT_STREQ("rgb(10, 10)", l.toString().c_str());
 }